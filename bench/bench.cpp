@@ -0,0 +1,53 @@
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace Bench {
+
+static volatile uint64_t sink = 0;
+static bool csv = false;
+static int failures = 0;
+
+void Init(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--csv") == 0) {
+      csv = true;
+    }
+    else {
+      fprintf(stderr, "Unknown argument %s\n", argv[i]);
+    }
+  }
+
+  if (csv) {
+    printf("name,value,unit\n");
+  }
+}
+
+void Report(const std::string& name, double value, const std::string& unit) {
+  if (csv) {
+    printf("%s,%.3f,%s\n", name.c_str(), value, unit.c_str());
+  }
+  else {
+    printf("%-48s %16.1f %s\n", name.c_str(), value, unit.c_str());
+  }
+  fflush(stdout);
+}
+
+void Check(bool ok, const std::string& what) {
+  if (!ok) {
+    fprintf(stderr, "FAILED: %s\n", what.c_str());
+    ++failures;
+  }
+}
+
+int GetFailures() {
+  return failures;
+}
+
+void Consume(uint64_t value) {
+  sink = sink + value;
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Bench {
+
+const auto kDefaultMinTime = std::chrono::milliseconds(250);
+
+// Every benchmark draws its random inputs from this seed and measures the same fixed world regions, so results are
+// comparable between runs and between releases
+const uint32_t kSeed = 1234;
+
+// Reads the command line. --csv switches the report to "name,value,unit" lines for tools to diff
+void Init(int argc, char** argv);
+
+// Calls fn repeatedly until at least min_time has elapsed and returns the rate in operations per second, where each
+// call to fn performs ops_per_call operations
+template <typename Fn>
+double Measure(Fn&& fn, double ops_per_call, std::chrono::milliseconds min_time = kDefaultMinTime) {
+  using Clock = std::chrono::steady_clock;
+
+  fn(); // Warm up caches and allocations before timing
+
+  size_t calls = 0;
+  auto start_time = Clock::now();
+  auto elapsed = Clock::duration::zero();
+  do {
+    fn();
+    ++calls;
+    elapsed = Clock::now() - start_time;
+  } while (elapsed < min_time);
+
+  return calls * ops_per_call / std::chrono::duration<double>(elapsed).count();
+}
+
+void Report(const std::string& name, double value, const std::string& unit);
+
+// Records a failed expectation about the code being measured, so a run never reports rates for code that has stopped
+// doing its job. Failures are printed as they happen and give the run a non-zero exit status
+void Check(bool ok, const std::string& what);
+int GetFailures();
+
+// Feeds a result somewhere the optimiser can't see, so the work producing it isn't discarded
+void Consume(uint64_t value);
+
+}
@@ -0,0 +1,33 @@
+#include "bench.hpp"
+
+void RunChunkConnectivityBenchmarks();
+void RunChunkGeneratorBenchmarks();
+void RunChunkLightBenchmarks();
+void RunChunkLodBenchmarks();
+void RunChunkMapBenchmarks();
+void RunChunkMeshPoolBenchmarks();
+void RunChunkMesherBenchmarks();
+void RunChunkStorageBenchmarks();
+void RunDrawCommandBuilderBenchmarks();
+void RunRegionFileBenchmarks();
+void RunSlabAllocatorBenchmarks();
+void RunVoxelRaycastBenchmarks();
+
+int main(int argc, char** argv) {
+  Bench::Init(argc, argv);
+
+  RunChunkMapBenchmarks();
+  RunChunkGeneratorBenchmarks();
+  RunChunkStorageBenchmarks();
+  RunChunkLightBenchmarks();
+  RunChunkMesherBenchmarks();
+  RunChunkConnectivityBenchmarks();
+  RunChunkLodBenchmarks();
+  RunChunkMeshPoolBenchmarks();
+  RunDrawCommandBuilderBenchmarks();
+  RunRegionFileBenchmarks();
+  RunSlabAllocatorBenchmarks();
+  RunVoxelRaycastBenchmarks();
+
+  return Bench::GetFailures() > 0 ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_connectivity.hpp"
+#include "chunk_generator.hpp"
+#include "chunk_map.hpp"
+#include "chunk_snapshot.hpp"
+#include "chunk_storage.hpp"
+
+void RunChunkConnectivityBenchmarks() {
+  // The same stretch of surface as the mesher benchmarks, and the ground below it down to where the caves are
+  const int kSide = 4;
+  const int kMinY = -2;
+  const int kMaxY = 6;
+
+  ChunkMap<ChunkStorage> chunks;
+  for (int x = -1; x <= kSide; ++x) {
+    for (int y = kMinY - 1; y <= kMaxY + 1; ++y) {
+      for (int z = -1; z <= kSide; ++z) {
+        Block blocks[ChunkStorage::kNumBlocks];
+        ChunkGenerator::GenerateChunk(nullptr, x, y, z, blocks);
+        chunks.Insert(x, y, z, ChunkStorage(blocks));
+      }
+    }
+  }
+  auto get_chunk = [&](int x, int y, int z){ return (const ChunkStorage*)chunks.Find(x, y, z); };
+
+  std::vector<ChunkSnapshot> snapshots(kSide * (kMaxY - kMinY + 1) * kSide);
+  size_t i = 0;
+  for (int x = 0; x < kSide; ++x) {
+    for (int y = kMinY; y <= kMaxY; ++y) {
+      for (int z = 0; z < kSide; ++z) {
+        snapshots[i++].Fill(x, y, z, get_chunk);
+      }
+    }
+  }
+
+  double rate = Bench::Measure([&](){
+    for (const ChunkSnapshot& snapshot : snapshots) {
+      Bench::Consume(ChunkConnectivity::Compute(snapshot).Connects(0, 1));
+    }
+  }, (double)snapshots.size());
+  Bench::Report("connectivity_chunk", rate, "chunks/s");
+
+  // How often the search in ChunkOcclusionCuller is stopped: chunks seen through from no face, and chunks where at
+  // least one pair of faces doesn't see through
+  size_t walled = 0, partly_walled = 0;
+  for (const ChunkSnapshot& snapshot : snapshots) {
+    ChunkConnectivity connectivity = ChunkConnectivity::Compute(snapshot);
+    walled += connectivity == ChunkConnectivity::None();
+    partly_walled += connectivity != ChunkConnectivity::All();
+  }
+  Bench::Report("connectivity_walled_percent", 100.0 * walled / snapshots.size(), "%");
+  Bench::Report("connectivity_partly_walled_percent", 100.0 * partly_walled / snapshots.size(), "%");
+
+  // A chunk of air split by a wall across x. Each side still sees through to the faces beside it, -y and +y
+  // included, but not to the far side, until a hole is knocked in the wall
+  const int kSize = ChunkConstants::kChunkSize;
+  const int kNegX = 0, kPosX = 1, kNegY = 2, kPosY = 3, kNegZ = 4;
+  ChunkSnapshot& walled_chunk = snapshots[0];
+  std::fill(std::begin(walled_chunk.blocks), std::end(walled_chunk.blocks), Block::kAir);
+  for (int z = 0; z < kSize; ++z) {
+    for (int y = 0; y < kSize; ++y) {
+      walled_chunk.SetBlockAt(kSize / 2, y, z, Block::kBasalt);
+    }
+  }
+  ChunkConnectivity wall = ChunkConnectivity::Compute(walled_chunk);
+  Bench::Check(!wall.Connects(kNegX, kPosX) && !wall.Connects(kPosX, kNegX),
+               "ChunkConnectivity doesn't see through a wall");
+  Bench::Check(wall.Connects(kNegX, kNegY) && wall.Connects(kPosX, kPosY) && wall.Connects(kNegY, kPosY)
+            && wall.Connects(kNegX, kNegZ), "ChunkConnectivity sees along either side of a wall");
+
+  walled_chunk.SetBlockAt(kSize / 2, 5, 7, Block::kAir);
+  Bench::Check(ChunkConnectivity::Compute(walled_chunk).Connects(kNegX, kPosX),
+               "ChunkConnectivity sees through a hole in a wall");
+}
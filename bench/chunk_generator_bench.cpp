@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_constants.hpp"
+#include "chunk_generator.hpp"
+#include "simplex_noise.hpp"
+
+// The generator as it was before columns were sampled once and cached, kept to measure against. Both noise functions
+// are sampled for every block even though they only depend on x and z
+static void GenerateChunkPerBlock(int chunk_x, int chunk_y, int chunk_z, Block* blocks) {
+  const float kGradientSampleDistance = 0.01f;
+  const float kMountainHeight = 10.0f;
+  const float kDirtDepth = 4.0f;
+
+  for (int x = 0; x < ChunkConstants::kChunkSize; ++x) {
+    float block_x = chunk_x * (float)ChunkConstants::kChunkSize + x;
+    for (int y = 0; y < ChunkConstants::kChunkSize; ++y) {
+      float block_y = chunk_y * (float)ChunkConstants::kChunkSize + y;
+      for (int z = 0; z < ChunkConstants::kChunkSize; ++z) {
+        float block_z = chunk_z * (float)ChunkConstants::kChunkSize + z;
+        int index = x + y * ChunkConstants::kChunkSize + z * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize;
+
+        float surface_height = SimplexNoise::Noise2d(block_x * kGradientSampleDistance, block_z * kGradientSampleDistance) * kMountainHeight;
+        if (block_y < surface_height) {
+          blocks[index] = Block::kAir;
+          continue;
+        }
+        blocks[index] = Block::kBasalt;
+        float dirt_depth = std::fabs(SimplexNoise::Noise3d(block_x * kGradientSampleDistance, block_z * kGradientSampleDistance, 967.15f) + 0.9f) * kDirtDepth;
+        if (block_y < surface_height + dirt_depth) {
+          blocks[index] = Block::kDirt;
+        }
+        if (block_y < surface_height + 1.0f) {
+          blocks[index] = Block::kGrass;
+        }
+      }
+    }
+  }
+}
+
+void RunChunkGeneratorBenchmarks() {
+  const int kSide = 4;
+  const int kStackHeight = 8; // Chunks loaded above and below each other, sharing a column
+  Block blocks[ChunkConstants::kChunkSize * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize];
+
+  // Points spaced as the generator samples its columns, across the view volume measured below. Sampled one point at a
+  // time and then in batches
+  const int kNoiseSide = 25 * ChunkConstants::kChunkSize;
+  std::vector<float> noise_x, noise_z, noise_layer;
+  for (int z = 0; z < kNoiseSide; ++z) {
+    for (int x = 0; x < kNoiseSide; ++x) {
+      noise_x.push_back((x - kNoiseSide / 2) * 0.01f);
+      noise_z.push_back((z - kNoiseSide / 2) * 0.01f);
+      noise_layer.push_back(967.15f);
+    }
+  }
+  std::vector<float> scalar_2d(noise_x.size()), scalar_3d(noise_x.size());
+  std::vector<float> batched_2d(noise_x.size()), batched_3d(noise_x.size());
+
+  double scalar_noise_rate = Bench::Measure([&](){
+    for (size_t i = 0; i < noise_x.size(); ++i) {
+      scalar_2d[i] = SimplexNoise::Noise2d(noise_x[i], noise_z[i]);
+      scalar_3d[i] = SimplexNoise::Noise3d(noise_x[i], noise_z[i], noise_layer[i]);
+    }
+    Bench::Consume((uint64_t)(scalar_2d[0] + scalar_3d[0]));
+  }, (double)noise_x.size());
+  Bench::Report("noise_scalar", scalar_noise_rate, "columns/s");
+
+  double batched_noise_rate = Bench::Measure([&](){
+    SimplexNoise::Noise2d(noise_x.data(), noise_z.data(), noise_x.size(), batched_2d.data());
+    SimplexNoise::Noise3d(noise_x.data(), noise_z.data(), noise_layer.data(), noise_x.size(), batched_3d.data());
+    Bench::Consume((uint64_t)(batched_2d[0] + batched_3d[0]));
+  }, (double)noise_x.size());
+  Bench::Report("noise_batched", batched_noise_rate, "columns/s");
+
+  // Batches only differ from single points where the compiler fused a multiply and add in one and not the other
+  float noise_difference = 0.0f;
+  for (size_t i = 0; i < noise_x.size(); ++i) {
+    noise_difference = std::max(noise_difference, std::fabs(batched_2d[i] - scalar_2d[i]));
+    noise_difference = std::max(noise_difference, std::fabs(batched_3d[i] - scalar_3d[i]));
+  }
+  Bench::Check(noise_difference < 1e-3f, "batched simplex noise matches the single point functions");
+
+  double per_block_rate = Bench::Measure([&](){
+    uint64_t sum = 0;
+    for (int x = 0; x < kSide; ++x) {
+      for (int y = 0; y < kStackHeight; ++y) {
+        for (int z = 0; z < kSide; ++z) {
+          GenerateChunkPerBlock(x, y - kStackHeight / 2, z, blocks);
+          sum += (uint64_t)blocks[0];
+        }
+      }
+    }
+    Bench::Consume(sum);
+  }, (double)(kSide * kSide * kStackHeight));
+  Bench::Report("generate_per_block_noise", per_block_rate, "chunks/s");
+
+  // The generator samples its columns in batches, and the per-block generator one point at a time
+  size_t differing_blocks = 0;
+  for (int x = 0; x < kSide; ++x) {
+    for (int y = 0; y < kStackHeight; ++y) {
+      for (int z = 0; z < kSide; ++z) {
+        Block per_block[ChunkConstants::kChunkSize * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize];
+        GenerateChunkPerBlock(x, y - kStackHeight / 2, z, per_block);
+        ChunkGenerator::GenerateChunk(nullptr, x, y - kStackHeight / 2, z, blocks);
+        for (size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+          differing_blocks += blocks[i] != per_block[i];
+        }
+      }
+    }
+  }
+  Bench::Check(differing_blocks == 0, "ChunkGenerator generates the same blocks as the per-block generator");
+
+  // Every column sampled afresh, which is what a chunk in a column nothing else has touched costs
+  double uncached_rate = Bench::Measure([&](){
+    uint64_t sum = 0;
+    for (int x = 0; x < kSide; ++x) {
+      for (int z = 0; z < kSide; ++z) {
+        ChunkGenerator::ClearColumnCache();
+        ChunkGenerator::GenerateChunk(nullptr, x, 0, z, blocks);
+        sum += (uint64_t)blocks[0];
+      }
+    }
+    Bench::Consume(sum);
+  }, (double)(kSide * kSide));
+  Bench::Report("generate_uncached_column", uncached_rate, "chunks/s");
+
+  double stacked_rate = Bench::Measure([&](){
+    ChunkGenerator::ClearColumnCache();
+    uint64_t sum = 0;
+    for (int x = 0; x < kSide; ++x) {
+      for (int y = 0; y < kStackHeight; ++y) {
+        for (int z = 0; z < kSide; ++z) {
+          ChunkGenerator::GenerateChunk(nullptr, x, y - kStackHeight / 2, z, blocks);
+          sum += (uint64_t)blocks[0];
+        }
+      }
+    }
+    Bench::Consume(sum);
+  }, (double)(kSide * kSide * kStackHeight));
+  Bench::Report("generate_stacked_columns", stacked_rate, "chunks/s");
+
+  // The chunks within the default view distance, as the world loads them. Chunks wholly above or below the surface
+  // are told apart from their column and never generated
+  const int kViewDistance = 12;
+  const int kViewDistanceVertical = 3;
+  const int kNumViewChunks = (2 * kViewDistance + 1) * (2 * kViewDistance + 1) * (2 * kViewDistanceVertical + 1);
+  size_t num_uniform = 0;
+  double view_rate = Bench::Measure([&](){
+    ChunkGenerator::ClearColumnCache();
+    uint64_t sum = 0;
+    num_uniform = 0;
+    for (int x = -kViewDistance; x <= kViewDistance; ++x) {
+      for (int z = -kViewDistance; z <= kViewDistance; ++z) {
+        for (int y = -kViewDistanceVertical; y <= kViewDistanceVertical; ++y) {
+          Block uniform;
+          if (ChunkGenerator::GetUniformBlock(x, y, z, uniform)) {
+            sum += (uint64_t)uniform;
+            ++num_uniform;
+            continue;
+          }
+          ChunkGenerator::GenerateChunk(nullptr, x, y, z, blocks);
+          sum += (uint64_t)blocks[0];
+        }
+      }
+    }
+    Bench::Consume(sum);
+  }, (double)kNumViewChunks);
+  Bench::Report("generate_view_volume", view_rate, "chunks/s");
+  Bench::Report("uniform_chunk_percent", 100.0 * num_uniform / kNumViewChunks, "%");
+
+  ChunkGenerator::ClearColumnCache();
+}
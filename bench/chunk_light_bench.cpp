@@ -0,0 +1,96 @@
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_generator.hpp"
+#include "chunk_light.hpp"
+#include "chunk_lighter.hpp"
+#include "chunk_map.hpp"
+#include "chunk_snapshot.hpp"
+#include "chunk_storage.hpp"
+
+void RunChunkLightBenchmarks() {
+  // The same stretch of surface as the mesher benchmarks, with the outer shell loaded so every lit chunk has all of
+  // its neighbours
+  const int kSide = 4;
+  const int kMinY = -2;
+
+  ChunkMap<ChunkStorage> chunks;
+  for (int x = -1; x <= kSide; ++x) {
+    for (int y = kMinY - 1; y <= kMinY + kSide; ++y) {
+      for (int z = -1; z <= kSide; ++z) {
+        Block blocks[ChunkStorage::kNumBlocks];
+        ChunkGenerator::GenerateChunk(nullptr, x, y, z, blocks);
+        chunks.Insert(x, y, z, ChunkStorage(blocks));
+      }
+    }
+  }
+  auto get_chunk = [&](int x, int y, int z){ return (const ChunkStorage*)chunks.Find(x, y, z); };
+
+  // As the world does it as chunks stream in, from the sky down so each chunk sees the light of the one above. The
+  // lights found are kept for the benchmarks below
+  ChunkMap<ChunkLight> lights;
+  auto get_light = [&](int x, int y, int z){ return (const ChunkLight*)lights.Find(x, y, z); };
+  ChunkSnapshot snapshot;
+  double sweep_rate = Bench::Measure([&](){
+    lights.Clear();
+    for (int y = kMinY - 1; y <= kMinY + kSide; ++y) {
+      for (int x = -1; x <= kSide; ++x) {
+        for (int z = -1; z <= kSide; ++z) {
+          snapshot.Fill(x, y, z, get_chunk);
+          snapshot.FillLight(x, y, z, get_light);
+          ChunkLight light;
+          ChunkLighter::ComputeLight(snapshot, light);
+          lights.Insert(x, y, z, light);
+        }
+      }
+    }
+    Bench::Consume(lights.Size());
+  }, (double)((kSide + 2) * (kSide + 2) * (kSide + 2)));
+  Bench::Report("light_sweep", sweep_rate, "chunks/s");
+
+  size_t uniform_lights = 0;
+  size_t light_bytes = 0;
+  lights.ForEach([&](const ChunkLight& lit){
+    uniform_lights += lit.IsUniform();
+    light_bytes += lit.GetMemoryUsage();
+  });
+  Bench::Report("chunk_light_uniform", (double)uniform_lights, "chunks");
+  Bench::Report("chunk_light_array_bytes", (double)ChunkStorage::kNumBlocks, "bytes/chunk");
+  Bench::Report("chunk_light_bytes", (double)light_bytes / lights.Size(), "bytes/chunk");
+
+  // Relighting chunks whose neighbours are all lit, as after a block edit
+  std::vector<ChunkSnapshot> snapshots(kSide * kSide * kSide);
+  size_t i = 0;
+  for (int x = 0; x < kSide; ++x) {
+    for (int y = kMinY; y < kMinY + kSide; ++y) {
+      for (int z = 0; z < kSide; ++z) {
+        snapshots[i].Fill(x, y, z, get_chunk);
+        snapshots[i++].FillLight(x, y, z, get_light);
+      }
+    }
+  }
+
+  ChunkLight light;
+  double relight_rate = Bench::Measure([&](){
+    for (const ChunkSnapshot& relit : snapshots) {
+      ChunkLighter::ComputeLight(relit, light);
+    }
+    Bench::Consume(light.Get(0));
+  }, (double)snapshots.size());
+  Bench::Report("light_chunk", relight_rate, "chunks/s");
+
+  // Open sky, where every block is lit and the flood fill does the most work
+  Block sky_blocks[ChunkStorage::kNumBlocks];
+  ChunkGenerator::GenerateChunk(nullptr, 0, -20, 0, sky_blocks);
+  ChunkMap<ChunkStorage> sky;
+  sky.Insert(0, 0, 0, ChunkStorage(sky_blocks));
+  snapshot.Fill(0, 0, 0, [&](int x, int y, int z){ return (const ChunkStorage*)sky.Find(x, y, z); });
+  snapshot.FillLight(0, 0, 0, [](int, int, int){ return (const ChunkLight*)nullptr; });
+  double sky_rate = Bench::Measure([&](){
+    ChunkLighter::ComputeLight(snapshot, light);
+    Bench::Consume(light.Get(0));
+  }, 1.0);
+  Bench::Report("light_chunk/open_sky", sky_rate, "chunks/s");
+  Bench::Check(light.IsUniform() && light.Get(0) == ChunkLight::Pack(ChunkLight::kMaxLight, 0),
+               "ChunkLight keeps open sky as a single value");
+}
@@ -0,0 +1,89 @@
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_generator.hpp"
+#include "chunk_lod.hpp"
+#include "chunk_map.hpp"
+#include "chunk_mesher.hpp"
+#include "chunk_snapshot.hpp"
+#include "chunk_storage.hpp"
+
+void RunChunkLodBenchmarks() {
+  ChunkMeshArena arena;
+
+  // A cell half grass over half dirt keeps the grass on top. +y points into the ground, so the grass is at the lower y
+  {
+    const int kScale = 2;
+    const int kSide = ChunkConstants::kChunkSize * kScale;
+    std::vector<Block> volume((size_t)kSide * kSide * kSide, Block::kAir);
+    for (int z = 0; z < kScale; ++z) {
+      for (int x = 0; x < kScale; ++x) {
+        volume[x + 10 * kSide + z * kSide * kSide] = Block::kGrass;
+        volume[x + 11 * kSide + z * kSide * kSide] = Block::kDirt;
+      }
+    }
+    Block cells[ChunkStorage::kNumBlocks];
+    ChunkLod::Downsample(volume.data(), kScale, cells);
+    Bench::Check(cells[ChunkStorage::Index(0, 5, 0)] == Block::kGrass, "Downsample keeps the top block of a surface");
+  }
+
+  for (int level = 1; level <= ChunkLod::kMaxLevels; ++level) {
+    const int kScale = ChunkLod::ScaleOf(level);
+    std::string suffix = "/lod" + std::to_string(level);
+
+    // The two nodes stacked either side of y = 0 hold the whole surface
+    double build_rate = Bench::Measure([&](){
+      ChunkStorage lower = ChunkLod::BuildNode(nullptr, level, 0, -1, 0);
+      ChunkStorage upper = ChunkLod::BuildNode(nullptr, level, 0, 0, 0);
+      Bench::Consume((uint64_t)lower.Get(0) + (uint64_t)upper.Get(0));
+    }, 2.0);
+    Bench::Report("node_build" + suffix, build_rate, "nodes/s");
+
+    // Faces drawn for the same stretch of world at full detail and as nodes. Neither sees past the edges of the
+    // stretch, so both close it off the same way
+    ChunkMap<ChunkStorage> nodes;
+    nodes.Insert(0, -1, 0, ChunkLod::BuildNode(nullptr, level, 0, -1, 0));
+    nodes.Insert(0, 0, 0, ChunkLod::BuildNode(nullptr, level, 0, 0, 0));
+    auto get_node = [&](int x, int y, int z){ return (const ChunkStorage*)nodes.Find(x, y, z); };
+
+    // Both lit as open sky, so light doesn't change how faces merge
+    auto no_light = [](int, int, int){ return (const ChunkLight*)nullptr; };
+    ChunkSnapshot snapshot;
+    size_t lod_faces = 0;
+    for (int y = -1; y <= 0; ++y) {
+      snapshot.Fill(0, y, 0, get_node);
+      snapshot.FillLight(0, y, 0, no_light);
+      ChunkMesher::BuildMesh(snapshot, MeshingMode::kGreedy, arena);
+      lod_faces += arena.num_indices / 6;
+    }
+
+    ChunkMap<ChunkStorage> chunks;
+    for (int x = 0; x < kScale; ++x) {
+      for (int y = -kScale; y < kScale; ++y) {
+        for (int z = 0; z < kScale; ++z) {
+          Block blocks[ChunkStorage::kNumBlocks];
+          ChunkGenerator::GenerateChunk(nullptr, x, y, z, blocks);
+          chunks.Insert(x, y, z, ChunkStorage(blocks));
+        }
+      }
+    }
+    auto get_chunk = [&](int x, int y, int z){ return (const ChunkStorage*)chunks.Find(x, y, z); };
+
+    size_t full_faces = 0;
+    for (int x = 0; x < kScale; ++x) {
+      for (int y = -kScale; y < kScale; ++y) {
+        for (int z = 0; z < kScale; ++z) {
+          snapshot.Fill(x, y, z, get_chunk);
+          snapshot.FillLight(x, y, z, no_light);
+          ChunkMesher::BuildMesh(snapshot, MeshingMode::kGreedy, arena);
+          full_faces += arena.num_indices / 6;
+        }
+      }
+    }
+
+    Bench::Report("lod_faces" + suffix, (double)lod_faces, "faces");
+    Bench::Report("full_detail_faces" + suffix, (double)full_faces, "faces");
+    Bench::Report("lod_face_percent" + suffix, full_faces > 0 ? 100.0 * lod_faces / full_faces : 0.0, "%");
+  }
+}
@@ -0,0 +1,99 @@
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_map.hpp"
+
+struct ChunkCoord {
+  int x, y, z;
+};
+
+// Stand-in for the original World::GetChunkAt, which scanned every loaded chunk
+static const ChunkCoord* LinearFind(const std::vector<ChunkCoord>& chunks, int x, int y, int z) {
+  for (const ChunkCoord& chunk : chunks) {
+    if (chunk.x == x && chunk.y == y && chunk.z == z) {
+      return &chunk;
+    }
+  }
+  return nullptr;
+}
+
+// Fills a roughly cubic region centred on the origin, the shape a loaded world takes around the camera
+static std::vector<ChunkCoord> MakeLoadedRegion(size_t num_chunks) {
+  int side = (int)std::ceil(std::cbrt((double)num_chunks));
+  std::vector<ChunkCoord> chunks;
+  chunks.reserve(num_chunks);
+  for (int x = 0; x < side && chunks.size() < num_chunks; ++x) {
+    for (int y = 0; y < side && chunks.size() < num_chunks; ++y) {
+      for (int z = 0; z < side && chunks.size() < num_chunks; ++z) {
+        chunks.push_back({ x - side / 2, y - side / 2, z - side / 2 });
+      }
+    }
+  }
+  return chunks;
+}
+
+void RunChunkMapBenchmarks() {
+  const size_t kNumLookups = 4096;
+
+  for (size_t num_chunks : { 1000, 10000, 100000 }) {
+    std::vector<ChunkCoord> chunks = MakeLoadedRegion(num_chunks);
+
+    ChunkMap<int> map;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      map.Insert(chunks[i].x, chunks[i].y, chunks[i].z, (int)i);
+    }
+
+    // Mostly hits, with a few lookups just outside the loaded region as a neighbour query at the edge would do
+    std::mt19937 rng(Bench::kSeed);
+    std::uniform_int_distribution<size_t> pick(0, chunks.size() - 1);
+    std::vector<ChunkCoord> lookups(kNumLookups);
+    for (size_t i = 0; i < kNumLookups; ++i) {
+      lookups[i] = chunks[pick(rng)];
+      if (i % 8 == 0) {
+        lookups[i].x += 1 << 10;
+      }
+    }
+
+    std::string suffix = "/" + std::to_string(num_chunks);
+
+    double map_rate = Bench::Measure([&](){
+      uint64_t found = 0;
+      for (const ChunkCoord& c : lookups) {
+        found += map.Find(c.x, c.y, c.z) != nullptr;
+      }
+      Bench::Consume(found);
+    }, (double)kNumLookups);
+    Bench::Report("chunk_map_lookup" + suffix, map_rate, "lookups/s");
+
+    // The linear scan is far too slow to run over every lookup at large sizes
+    size_t linear_lookups = std::max<size_t>(16, kNumLookups * 1000 / num_chunks);
+    double linear_rate = Bench::Measure([&](){
+      uint64_t found = 0;
+      for (size_t i = 0; i < linear_lookups; ++i) {
+        const ChunkCoord& c = lookups[i];
+        found += LinearFind(chunks, c.x, c.y, c.z) != nullptr;
+      }
+      Bench::Consume(found);
+    }, (double)linear_lookups);
+    Bench::Report("linear_scan_lookup" + suffix, linear_rate, "lookups/s");
+
+    double churn_rate = Bench::Measure([&](){
+      for (size_t i = 0; i < kNumLookups; ++i) {
+        const ChunkCoord& c = chunks[i % chunks.size()];
+        map.Erase(c.x, c.y, c.z);
+        map.Insert(c.x, c.y, c.z, (int)i);
+      }
+    }, (double)kNumLookups);
+    Bench::Report("chunk_map_evict_insert" + suffix, churn_rate, "ops/s");
+
+    double iterate_rate = Bench::Measure([&](){
+      uint64_t sum = 0;
+      map.ForEach([&](int value){ sum += value; });
+      Bench::Consume(sum);
+    }, (double)map.Size());
+    Bench::Report("chunk_map_iterate" + suffix, iterate_rate, "chunks/s");
+  }
+}
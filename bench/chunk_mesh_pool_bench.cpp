@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_generator.hpp"
+#include "chunk_map.hpp"
+#include "chunk_mesh_pool.hpp"
+#include "chunk_mesher.hpp"
+#include "chunk_snapshot.hpp"
+#include "draw_command_builder.hpp"
+#include "range_allocator.hpp"
+
+void RunChunkMeshPoolBenchmarks() {
+  // A freed range merges with the free range before it, after it, or both, and growing extends the free tail
+  {
+    RangeAllocator ranges(100);
+    uint32_t offsets[5];
+    for (uint32_t& offset : offsets) {
+      offset = ranges.Allocate(10);
+    }
+    ranges.Free(offsets[0], 10);
+    Bench::Check(ranges.GetNumFreeRanges() == 2, "RangeAllocator keeps apart free ranges that don't touch");
+    ranges.Free(offsets[1], 10);
+    Bench::Check(ranges.GetNumFreeRanges() == 2 && ranges.GetLargestFreeRange() == 50,
+                 "RangeAllocator merges a freed range with the free range before it");
+    ranges.Free(offsets[4], 10);
+    ranges.Free(offsets[3], 10);
+    Bench::Check(ranges.GetNumFreeRanges() == 2 && ranges.GetLargestFreeRange() == 70,
+                 "RangeAllocator merges a freed range with the free range after it");
+    ranges.Free(offsets[2], 10);
+    Bench::Check(ranges.GetNumFreeRanges() == 1 && ranges.GetUsed() == 0 && ranges.Allocate(100) == 0,
+                 "RangeAllocator merges a freed range with the free ranges on both sides");
+
+    Bench::Check(ranges.Allocate(1) == RangeAllocator::kInvalidOffset, "RangeAllocator fails when full");
+    ranges.Grow(150);
+    Bench::Check(ranges.Allocate(50) == 100 && ranges.GetCapacity() == 150,
+                 "RangeAllocator allocates from grown space");
+
+    RangeAllocator tail(100);
+    tail.Allocate(60);
+    tail.Grow(200);
+    Bench::Check(tail.GetNumFreeRanges() == 1 && tail.GetLargestFreeRange() == 140 && tail.GetUsedEnd() == 60,
+                 "RangeAllocator merges grown space with the free range at the end");
+  }
+
+  // Random allocations and frees the size of typical chunk meshes, as remeshing and streaming would make
+  {
+    const uint32_t kCapacity = 1 << 20;
+    const size_t kLive = 512;
+
+    RangeAllocator ranges(kCapacity);
+    std::mt19937 rng(Bench::kSeed);
+    std::uniform_int_distribution<uint32_t> pick_size(16, 1024);
+    struct Live { uint32_t offset, size; };
+    std::vector<Live> live;
+    for (size_t i = 0; i < kLive; ++i) {
+      uint32_t size = pick_size(rng);
+      live.push_back({ ranges.Allocate(size), size });
+    }
+
+    const size_t kChurn = 4096;
+    double churn_rate = Bench::Measure([&](){
+      for (size_t i = 0; i < kChurn; ++i) {
+        Live& victim = live[rng() % live.size()];
+        ranges.Free(victim.offset, victim.size);
+        victim.size = pick_size(rng);
+        victim.offset = ranges.Allocate(victim.size);
+      }
+    }, (double)kChurn);
+    Bench::Report("range_allocator_free_allocate", churn_rate, "ops/s");
+    Bench::Report("range_allocator_free_ranges", (double)ranges.GetNumFreeRanges(), "ranges");
+    Bench::Report("range_allocator_used_fraction", (double)ranges.GetUsed() / ranges.GetUsedEnd(), "fraction");
+  }
+
+  // Real meshes from one page of terrain, stored over and over as a chunk being remeshed would be
+  const int kSide = ChunkMeshPool::kPageSize;
+  ChunkMap<ChunkStorage> chunks;
+  for (int x = -1; x <= kSide; ++x) {
+    for (int y = -2; y <= kSide - 1; ++y) {
+      for (int z = -1; z <= kSide; ++z) {
+        Block blocks[ChunkStorage::kNumBlocks];
+        ChunkGenerator::GenerateChunk(nullptr, x, y, z, blocks);
+        chunks.Insert(x, y, z, ChunkStorage(blocks));
+      }
+    }
+  }
+  auto get_chunk = [&](int x, int y, int z){ return (const ChunkStorage*)chunks.Find(x, y, z); };
+
+  struct Meshed { int x, y, z; ChunkMesh mesh; };
+  std::vector<Meshed> meshes;
+  ChunkMeshArena arena;
+  ChunkSnapshot snapshot;
+  for (int x = 0; x < kSide; ++x) {
+    for (int y = -1; y < kSide - 1; ++y) {
+      for (int z = 0; z < kSide; ++z) {
+        snapshot.Fill(x, y, z, get_chunk);
+        snapshot.FillLight(x, y, z, [](int, int, int){ return (const ChunkLight*)nullptr; });
+        meshes.push_back({ x, y, z, ChunkMesher::CreateMesh(snapshot, MeshingMode::kGreedy, arena) });
+      }
+    }
+  }
+
+  ChunkMeshPool pool;
+  std::mt19937 rng(Bench::kSeed);
+  double store_rate = Bench::Measure([&](){
+    for (size_t i = 0; i < meshes.size(); ++i) {
+      const Meshed& meshed = meshes[rng() % meshes.size()];
+      pool.Store(meshed.x, meshed.y, meshed.z, meshed.mesh);
+    }
+  }, (double)meshes.size());
+  Bench::Report("chunk_mesh_pool_store", store_rate, "meshes/s");
+
+  ChunkMeshPool::Stats stats = pool.GetStats();
+  Bench::Report("chunk_mesh_pool_pages", (double)stats.pages, "pages");
+  Bench::Report("chunk_mesh_pool_used_fraction", (double)stats.used_bytes / stats.total_bytes, "fraction");
+}
+
+void RunDrawCommandBuilderBenchmarks() {
+  // Ranges that touch merge within a batch, however they were added, but never into another batch's ranges, which
+  // are drawn from other buffers
+  {
+    DrawCommandBuilder builder;
+    size_t first = builder.AddBatch(7);
+    size_t second = builder.AddBatch(8);
+    builder.AddRange(second, 18, 6);
+    builder.AddRange(first, 12, 6);
+    builder.AddRange(first, 30, 6);
+    builder.AddRange(first, 0, 12);
+    builder.AddRange(second, 24, 6);
+    builder.Finish();
+
+    const std::vector<DrawCommandBuilder::Batch>& batches = builder.GetBatches();
+    const std::vector<DrawIndirectCommand>& commands = builder.GetCommands();
+    auto is_command = [&](size_t i, uint32_t first_index, uint32_t index_count){
+      return commands[i].first_index == first_index && commands[i].index_count == index_count;
+    };
+    Bench::Check(batches[first].num_commands == 2 && is_command(batches[first].first_command, 0, 18)
+              && is_command(batches[first].first_command + 1, 30, 6),
+                 "DrawCommandBuilder merges touching ranges within a batch");
+    Bench::Check(batches[second].num_commands == 1 && is_command(batches[second].first_command, 18, 12),
+                 "DrawCommandBuilder never merges ranges across batches");
+  }
+
+  // The chunks within the default view distance, a page of kPageSize^3 chunks per batch, with index ranges laid out as
+  // a pool page would after some churn
+  const size_t kNumPages = 80;
+  const int kChunksPerPage = ChunkMeshPool::kPageSize * ChunkMeshPool::kPageSize * ChunkMeshPool::kPageSize;
+
+  std::mt19937 rng(Bench::kSeed);
+  struct Range { uint32_t first_index, index_count; };
+  std::vector<std::vector<Range>> pages(kNumPages);
+  for (auto& page : pages) {
+    uint32_t offset = 0;
+    for (int i = 0; i < kChunksPerPage; ++i) {
+      uint32_t count = 6 * (1 + rng() % 40);
+      offset += rng() % 4 == 0 ? 6 * (rng() % 20) : 0; // Some ranges left free
+      page.push_back({ offset, count });
+      offset += count;
+    }
+    std::shuffle(page.begin(), page.end(), rng);
+  }
+
+  DrawCommandBuilder builder;
+  double build_rate = Bench::Measure([&](){
+    builder.Clear();
+    for (size_t p = 0; p < kNumPages; ++p) {
+      size_t batch = builder.AddBatch((uint32_t)p);
+      for (const Range& range : pages[p]) {
+        builder.AddRange(batch, range.first_index, range.index_count);
+      }
+    }
+    builder.Finish();
+    Bench::Consume(builder.GetCommands().size());
+  }, (double)(kNumPages * kChunksPerPage));
+  Bench::Report("draw_command_build", build_rate, "chunks/s");
+  Bench::Report("draw_command_chunks", (double)(kNumPages * kChunksPerPage), "chunks");
+  Bench::Report("draw_command_commands", (double)builder.GetCommands().size(), "commands");
+  Bench::Report("draw_command_batches", (double)builder.GetBatches().size(), "draw calls");
+}
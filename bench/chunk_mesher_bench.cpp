@@ -0,0 +1,107 @@
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_generator.hpp"
+#include "chunk_light.hpp"
+#include "chunk_lighter.hpp"
+#include "chunk_map.hpp"
+#include "chunk_mesher.hpp"
+#include "chunk_snapshot.hpp"
+#include "chunk_storage.hpp"
+
+void RunChunkMesherBenchmarks() {
+  // Chunks around the surface, where meshes are largest. The outer shell is loaded so that every meshed chunk has all
+  // of its neighbours, as it would in the middle of the world
+  const int kSide = 4;
+  const int kMinY = -2;
+
+  ChunkMap<ChunkStorage> chunks;
+  for (int x = -1; x <= kSide; ++x) {
+    for (int y = kMinY - 1; y <= kMinY + kSide; ++y) {
+      for (int z = -1; z <= kSide; ++z) {
+        Block blocks[ChunkStorage::kNumBlocks];
+        ChunkGenerator::GenerateChunk(nullptr, x, y, z, blocks);
+        chunks.Insert(x, y, z, ChunkStorage(blocks));
+      }
+    }
+  }
+  auto get_chunk = [&](int x, int y, int z){ return (const ChunkStorage*)chunks.Find(x, y, z); };
+
+  // Lit in one pass from the sky down, so meshes have the light and ambient occlusion they would in the world
+  ChunkMap<ChunkLight> lights;
+  auto get_light = [&](int x, int y, int z){ return (const ChunkLight*)lights.Find(x, y, z); };
+  ChunkSnapshot light_snapshot;
+  for (int y = kMinY - 1; y <= kMinY + kSide; ++y) {
+    for (int x = -1; x <= kSide; ++x) {
+      for (int z = -1; z <= kSide; ++z) {
+        light_snapshot.Fill(x, y, z, get_chunk);
+        light_snapshot.FillLight(x, y, z, get_light);
+        ChunkLight light;
+        ChunkLighter::ComputeLight(light_snapshot, light);
+        lights.Insert(x, y, z, light);
+      }
+    }
+  }
+
+  std::vector<ChunkSnapshot> snapshots(kSide * kSide * kSide);
+  double snapshot_rate = Bench::Measure([&](){
+    size_t i = 0;
+    for (int x = 0; x < kSide; ++x) {
+      for (int y = kMinY; y < kMinY + kSide; ++y) {
+        for (int z = 0; z < kSide; ++z) {
+          snapshots[i].Fill(x, y, z, get_chunk);
+          snapshots[i++].FillLight(x, y, z, get_light);
+        }
+      }
+    }
+    Bench::Consume((uint64_t)snapshots[0].blocks[0]);
+  }, (double)snapshots.size());
+  Bench::Report("snapshot_fill", snapshot_rate, "chunks/s");
+
+  ChunkMeshArena arena;
+  size_t mode_faces[2] = { };
+  for (MeshingMode mode : { MeshingMode::kNaive, MeshingMode::kGreedy }) {
+    std::string suffix = mode == MeshingMode::kNaive ? "/naive" : "/greedy";
+
+    size_t faces = 0;
+    size_t bytes = 0;
+    for (const ChunkSnapshot& snapshot : snapshots) {
+      ChunkMesher::BuildMesh(snapshot, mode, arena);
+      faces += arena.num_indices / 6;
+      bytes += arena.num_vertex_floats * sizeof(float) + arena.num_indices * sizeof(uint32_t);
+    }
+    mode_faces[mode == MeshingMode::kNaive ? 0 : 1] = faces;
+
+    double mesh_rate = Bench::Measure([&](){
+      uint64_t num_indices = 0;
+      for (const ChunkSnapshot& snapshot : snapshots) {
+        ChunkMesher::BuildMesh(snapshot, mode, arena);
+        num_indices += arena.num_indices;
+      }
+      Bench::Consume(num_indices);
+    }, (double)snapshots.size());
+
+    // As the workers do it, copying each mesh out of the arena to hand it to the main thread
+    double handoff_rate = Bench::Measure([&](){
+      uint64_t num_indices = 0;
+      for (const ChunkSnapshot& snapshot : snapshots) {
+        num_indices += ChunkMesher::CreateMesh(snapshot, mode, arena).indices.size();
+      }
+      Bench::Consume(num_indices);
+    }, (double)snapshots.size());
+
+    // Every pass meshes the same chunks, so faces and bytes scale with the chunk rate
+    Bench::Report("mesh" + suffix, mesh_rate, "chunks/s");
+    Bench::Report("mesh_faces" + suffix, mesh_rate * faces / snapshots.size(), "faces/s");
+    Bench::Report("mesh_bytes" + suffix, mesh_rate * bytes / snapshots.size(), "bytes/s");
+    Bench::Report("mesh_handoff" + suffix, handoff_rate, "chunks/s");
+    Bench::Report("mesh_faces_per_chunk" + suffix, (double)faces / snapshots.size(), "faces");
+  }
+
+  // Faces shaded by ambient occlusion still merge along the edges they are lit evenly along, so the greedy mesher
+  // should come close to halving the faces around the surface
+  double greedy_ratio = (double)mode_faces[1] / mode_faces[0];
+  Bench::Report("mesh_greedy_face_ratio", greedy_ratio, "x");
+  Bench::Check(greedy_ratio <= 0.55, "Greedy meshing merges faces lit unevenly along only one axis");
+}
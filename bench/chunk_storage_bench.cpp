@@ -0,0 +1,54 @@
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_generator.hpp"
+#include "chunk_storage.hpp"
+
+void RunChunkStorageBenchmarks() {
+  const int kSide = 8;
+
+  // A column of chunks from deep underground to high in the air, as the streamer would load around the camera
+  std::vector<std::vector<Block>> arrays;
+  std::vector<ChunkStorage> storages;
+  size_t modes[3] = { };
+  size_t storage_bytes = 0;
+  for (int x = 0; x < kSide; ++x) {
+    for (int y = -kSide / 2; y < kSide / 2; ++y) {
+      for (int z = 0; z < kSide; ++z) {
+        arrays.emplace_back(ChunkStorage::kNumBlocks);
+        ChunkGenerator::GenerateChunk(nullptr, x, y, z, arrays.back().data());
+        storages.emplace_back(arrays.back().data());
+        ++modes[(int)storages.back().GetMode()];
+        storage_bytes += storages.back().GetMemoryUsage();
+      }
+    }
+  }
+
+  Bench::Report("chunk_storage_uniform", (double)modes[(int)ChunkStorage::Mode::kUniform], "chunks");
+  Bench::Report("chunk_storage_palette", (double)modes[(int)ChunkStorage::Mode::kPalette], "chunks");
+  Bench::Report("chunk_storage_dense", (double)modes[(int)ChunkStorage::Mode::kDense], "chunks");
+  Bench::Report("chunk_storage_array_bytes", (double)ChunkStorage::kNumBlocks * sizeof(Block), "bytes/chunk");
+  Bench::Report("chunk_storage_bytes", (double)storage_bytes / storages.size(), "bytes/chunk");
+
+  double array_rate = Bench::Measure([&](){
+    uint64_t solid = 0;
+    for (const auto& blocks : arrays) {
+      for (int i = 0; i < ChunkStorage::kNumBlocks; ++i) {
+        solid += blocks[i] != Block::kAir;
+      }
+    }
+    Bench::Consume(solid);
+  }, (double)arrays.size() * ChunkStorage::kNumBlocks);
+  Bench::Report("block_array_get", array_rate, "blocks/s");
+
+  double storage_rate = Bench::Measure([&](){
+    uint64_t solid = 0;
+    for (const ChunkStorage& storage : storages) {
+      for (int i = 0; i < ChunkStorage::kNumBlocks; ++i) {
+        solid += storage.Get(i) != Block::kAir;
+      }
+    }
+    Bench::Consume(solid);
+  }, (double)storages.size() * ChunkStorage::kNumBlocks);
+  Bench::Report("chunk_storage_get", storage_rate, "blocks/s");
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_codec.hpp"
+#include "chunk_constants.hpp"
+#include "chunk_generator.hpp"
+#include "region_store.hpp"
+
+const size_t kNumBlocks = ChunkConstants::kChunkSize * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize;
+
+// Loading a saved chunk only pays off if it beats generating it again, so both are measured over the same chunks
+void RunRegionFileBenchmarks() {
+  const int kSide = 8; // One region's worth of chunks
+
+  std::vector<std::vector<Block>> chunks;
+  size_t encoded_bytes = 0;
+  for (int x = 0; x < kSide; ++x) {
+    for (int y = -kSide / 2; y < kSide / 2; ++y) {
+      for (int z = 0; z < kSide; ++z) {
+        chunks.emplace_back(kNumBlocks);
+        ChunkGenerator::GenerateChunk(nullptr, x, y, z, chunks.back().data());
+        std::vector<uint8_t> encoded;
+        ChunkCodec::Encode(chunks.back().data(), encoded);
+        encoded_bytes += encoded.size();
+      }
+    }
+  }
+  Bench::Report("chunk_codec_ratio", (double)(chunks.size() * kNumBlocks * sizeof(Block)) / encoded_bytes, "x");
+
+  std::vector<Block> decoded(kNumBlocks);
+  double generate_rate = Bench::Measure([&](){
+    ChunkGenerator::GenerateChunk(nullptr, 3, 0, 5, decoded.data());
+    Bench::Consume((uint64_t)decoded[0]);
+  }, 1.0);
+  Bench::Report("chunk_generate", generate_rate, "chunks/s");
+
+  std::vector<uint8_t> encoded;
+  double encode_rate = Bench::Measure([&](){
+    encoded.clear();
+    ChunkCodec::Encode(chunks[0].data(), encoded);
+    Bench::Consume(encoded.size());
+  }, 1.0);
+  Bench::Report("chunk_encode", encode_rate, "chunks/s");
+
+  double decode_rate = Bench::Measure([&](){
+    Bench::Consume(ChunkCodec::Decode(encoded.data(), encoded.size(), decoded.data()));
+  }, 1.0);
+  Bench::Report("chunk_decode", decode_rate, "chunks/s");
+
+  std::filesystem::path directory = std::filesystem::temp_directory_path() / "calcium_cubes_region_bench";
+  std::filesystem::remove_all(directory);
+  {
+    RegionStore store(directory.string());
+
+    double store_rate = Bench::Measure([&](){
+      size_t i = 0;
+      for (int x = 0; x < kSide; ++x) {
+        for (int y = -kSide / 2; y < kSide / 2; ++y) {
+          for (int z = 0; z < kSide; ++z) {
+            store.StoreChunk(x, y, z, chunks[i++].data());
+          }
+        }
+      }
+      store.Flush();
+    }, (double)chunks.size());
+    Bench::Report("region_store", store_rate, "chunks/s");
+
+    // Every pass above rewrote the same chunks, which go back into their slots rather than growing the file
+    auto region_bytes = [&](){
+      uintmax_t bytes = 0;
+      for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        bytes += file.file_size();
+      }
+      return bytes;
+    };
+    uintmax_t bytes_before = region_bytes();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      store.StoreChunk((int)(i / (kSide * kSide)), (int)(i / kSide % kSide) - kSide / 2, (int)(i % kSide),
+                       chunks[i].data());
+    }
+    store.Flush();
+    Bench::Check(region_bytes() == bytes_before, "RegionFile rewrites chunks in place");
+  }
+
+  // A fresh store has no cached region handles or unwritten chunks, so every load reads from disk
+  RegionStore store(directory.string());
+  double load_rate = Bench::Measure([&](){
+    uint64_t loaded = 0;
+    for (int x = 0; x < kSide; ++x) {
+      for (int y = -kSide / 2; y < kSide / 2; ++y) {
+        for (int z = 0; z < kSide; ++z) {
+          loaded += store.LoadChunk(x, y, z, decoded.data());
+        }
+      }
+    }
+    Bench::Consume(loaded);
+  }, (double)chunks.size());
+  Bench::Report("region_load", load_rate, "chunks/s");
+
+  // One chunk in each of more regions than the store keeps open, so early regions are closed and opened again
+  const int kNumRegions = 80;
+  for (int i = 0; i < kNumRegions; ++i) {
+    store.StoreChunk(i * kSide, 0, 0, chunks[i].data());
+  }
+  store.Flush();
+  bool all_loaded = true;
+  for (int i = 0; i < kNumRegions; ++i) {
+    all_loaded &= store.LoadChunk(i * kSide, 0, 0, decoded.data())
+               && std::equal(decoded.data(), decoded.data() + kNumBlocks, chunks[i].data());
+  }
+  Bench::Check(all_loaded, "RegionStore loads chunks back from regions it has closed");
+  Bench::Check(!store.LoadChunk(0, kSide * 4, 0, decoded.data()) && !store.LoadChunk(0, kSide * 4, 0, decoded.data()),
+               "RegionStore finds no chunk in a region never written");
+  store.StoreChunk(0, kSide * 4, 0, chunks[0].data());
+  store.Flush();
+  Bench::Check(store.LoadChunk(0, kSide * 4, 0, decoded.data()), "RegionStore loads from a region once it is written");
+
+  // Loads from far more regions than are kept open, made while the writer is still appending to the same regions, so
+  // regions are closed and opened again under the writer. Every chunk must still be there for a store opened afterwards
+  const int kChunksPerRegion = 4;
+  const int kRounds = 20;
+  {
+    std::atomic<bool> writing = true;
+    std::vector<std::thread> loaders;
+    for (int t = 0; t < 4; ++t) {
+      loaders.emplace_back([&, t](){
+        std::vector<Block> blocks(kNumBlocks);
+        for (int i = t; writing.load(std::memory_order_relaxed); i = (i + 1) % kNumRegions) {
+          Bench::Consume(store.LoadChunk(i * kSide, 0, 0, blocks.data()));
+          Bench::Consume(store.LoadChunk(i * kSide, kSide * 8, 0, blocks.data()));
+        }
+      });
+    }
+    for (int round = 0; round < kRounds; ++round) {
+      for (int i = 0; i < kNumRegions; ++i) {
+        for (int j = 0; j < kChunksPerRegion; ++j) {
+          store.StoreChunk(i * kSide + j, kSide * 8, 0, chunks[(i + j + round) % chunks.size()].data());
+        }
+      }
+      store.Flush();
+    }
+    writing.store(false, std::memory_order_relaxed);
+    for (std::thread& loader : loaders) {
+      loader.join();
+    }
+  }
+  {
+    RegionStore reopened(directory.string());
+    bool all_kept = true;
+    for (int i = 0; i < kNumRegions; ++i) {
+      for (int j = 0; j < kChunksPerRegion; ++j) {
+        const Block* last_stored = chunks[(i + j + kRounds - 1) % chunks.size()].data();
+        all_kept &= reopened.LoadChunk(i * kSide + j, kSide * 8, 0, decoded.data())
+                 && std::equal(decoded.data(), decoded.data() + kNumBlocks, last_stored);
+      }
+    }
+    Bench::Check(all_kept, "RegionStore keeps every chunk written while regions are closed and opened again");
+  }
+
+  std::error_code error;
+  std::filesystem::remove_all(directory, error);
+}
@@ -0,0 +1,80 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_snapshot.hpp"
+#include "mpmc_queue.hpp"
+#include "slab_allocator.hpp"
+
+void RunSlabAllocatorBenchmarks() {
+  // Streaming keeps a window of objects alive, freeing the oldest as each new one arrives. Snapshot sized, the largest
+  // of the objects pooled
+  const size_t kSize = sizeof(ChunkSnapshot);
+  const size_t kLive = 256;
+  const size_t kChurn = 4096;
+
+  auto churn = [&](auto allocate, auto free){
+    std::vector<void*> window(kLive, nullptr);
+    for (size_t i = 0; i < kChurn; ++i) {
+      void*& slot = window[i % kLive];
+      if (slot) {
+        free(slot);
+      }
+      slot = allocate();
+      static_cast<char*>(slot)[0] = (char)i;
+    }
+    for (void* block : window) {
+      free(block);
+    }
+  };
+
+  SlabAllocator& slab = SlabAllocator::ForSize(kSize);
+  double slab_rate = Bench::Measure([&](){
+    churn([&](){ return slab.Allocate(); }, [&](void* block){ slab.Free(block); });
+  }, (double)kChurn);
+  Bench::Report("slab_churn", slab_rate, "allocs/s");
+
+  double heap_rate = Bench::Measure([&](){
+    churn([&](){ return ::operator new(kSize); }, [&](void* block){ ::operator delete(block); });
+  }, (double)kChurn);
+  Bench::Report("slab_churn/heap", heap_rate, "allocs/s");
+
+  // Allocated on one thread and freed on another, as chunks generated on the workers are unloaded on the main thread
+  auto cross_thread = [&](auto allocate, auto free){
+    MpmcQueue<void*> handoff(kLive);
+    std::thread producer([&](){
+      for (size_t i = 0; i < kChurn; ++i) {
+        void* block = allocate();
+        while (!handoff.TryPush(std::move(block))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    void* block;
+    for (size_t received = 0; received < kChurn; ) {
+      if (handoff.TryPop(block)) {
+        free(block);
+        ++received;
+      }
+      else {
+        std::this_thread::yield();
+      }
+    }
+    producer.join();
+  };
+
+  double slab_cross_rate = Bench::Measure([&](){
+    cross_thread([&](){ return slab.Allocate(); }, [&](void* block){ slab.Free(block); });
+  }, (double)kChurn);
+  Bench::Report("slab_cross_thread", slab_cross_rate, "allocs/s");
+
+  double heap_cross_rate = Bench::Measure([&](){
+    cross_thread([&](){ return ::operator new(kSize); }, [&](void* block){ ::operator delete(block); });
+  }, (double)kChurn);
+  Bench::Report("slab_cross_thread/heap", heap_cross_rate, "allocs/s");
+
+  SlabAllocator::Stats stats = slab.GetStats();
+  Bench::Report("slab_reuse_rate", stats.GetReuseRate() * 100.0, "%");
+  Bench::Report("slab_high_water", (double)stats.high_water, "blocks");
+}
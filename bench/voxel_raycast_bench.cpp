@@ -0,0 +1,91 @@
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "chunk_generator.hpp"
+#include "chunk_map.hpp"
+#include "chunk_storage.hpp"
+#include "voxel_raycast.hpp"
+
+void RunVoxelRaycastBenchmarks() {
+  // A patch of world reaching from well above the surface to below it, so rays cross open sky before meeting ground
+  const int kSide = 8;
+  const int kMinY = -6;
+  const int kMaxY = 3;
+  const int kSize = ChunkConstants::kChunkSize;
+
+  ChunkMap<ChunkStorage> chunks;
+  for (int x = 0; x < kSide; ++x) {
+    for (int y = kMinY; y <= kMaxY; ++y) {
+      for (int z = 0; z < kSide; ++z) {
+        Block blocks[ChunkStorage::kNumBlocks];
+        ChunkGenerator::GenerateChunk(nullptr, x, y, z, blocks);
+        chunks.Insert(x, y, z, ChunkStorage(blocks));
+      }
+    }
+  }
+  auto get_chunk = [&](int x, int y, int z){ return (const ChunkStorage*)chunks.Find(x, y, z); };
+
+  // Picking rays from the sky, each looking out and down at the ground as a player would
+  const size_t kNumRays = 4096;
+  std::vector<VoxelRaycast::Ray> rays(kNumRays);
+  std::mt19937 rng(Bench::kSeed);
+  std::uniform_real_distribution<float> horizontal(2.0f * kSize, (kSide - 2) * kSize);
+  std::uniform_real_distribution<float> height(kMinY * kSize + 12.0f, -8.0f);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  for (VoxelRaycast::Ray& ray : rays) {
+    ray.origin = glm::vec3(horizontal(rng), height(rng), horizontal(rng));
+    ray.dir = glm::vec3(unit(rng), 0.2f + 0.8f * std::abs(unit(rng)), unit(rng));
+    ray.max_dist = 128.0f;
+  }
+
+  std::vector<VoxelRaycast::Hit> hits(kNumRays);
+  double single_rate = Bench::Measure([&](){
+    size_t num_hits = 0;
+    for (const VoxelRaycast::Ray& ray : rays) {
+      num_hits += VoxelRaycast::Raycast(ray, get_chunk).hit;
+    }
+    Bench::Consume(num_hits);
+  }, (double)kNumRays);
+  Bench::Report("raycast", single_rate, "rays/s");
+
+  double batch_rate = Bench::Measure([&](){
+    VoxelRaycast::RaycastBatch(rays.data(), hits.data(), kNumRays, get_chunk);
+    Bench::Consume(hits[0].hit);
+  }, (double)kNumRays);
+  Bench::Report("raycast_batch", batch_rate, "rays/s");
+
+  // Looking up every block crossed in the world, without skipping chunks of air, for comparison
+  double per_block_rate = Bench::Measure([&](){
+    size_t num_hits = 0;
+    for (const VoxelRaycast::Ray& ray : rays) {
+      glm::vec3 dir = glm::normalize(ray.dir);
+      const int start[3] = { (int)std::floor(ray.origin.x), (int)std::floor(ray.origin.y), (int)std::floor(ray.origin.z) };
+      VoxelRaycast::Traversal blocks;
+      blocks.Init(ray.origin, dir, 1, start, 0.0f);
+      for (; blocks.t <= ray.max_dist; blocks.Step()) {
+        int chunk[3];
+        for (int a = 0; a < 3; ++a) {
+          chunk[a] = VoxelRaycast::FloorDiv(blocks.cell[a], kSize);
+        }
+        const ChunkStorage* storage = get_chunk(chunk[0], chunk[1], chunk[2]);
+        if (!storage) {
+          break;
+        }
+        if (BlockProps::IsSolid(storage->Get(blocks.cell[0] - chunk[0] * kSize, blocks.cell[1] - chunk[1] * kSize,
+                                             blocks.cell[2] - chunk[2] * kSize))) {
+          ++num_hits;
+          break;
+        }
+      }
+    }
+    Bench::Consume(num_hits);
+  }, (double)kNumRays);
+  Bench::Report("raycast/per_block", per_block_rate, "rays/s");
+
+  size_t num_hits = 0;
+  for (const VoxelRaycast::Hit& hit : hits) {
+    num_hits += hit.hit;
+  }
+  Bench::Report("raycast_hit_percent", 100.0 * num_hits / kNumRays, "%");
+}
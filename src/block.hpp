@@ -1,17 +1,63 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 enum class Block : char {
   kUndefined, kAir, kDirt, kLimestone, kBasalt, kGrass,
+  kCount
 };
 
 enum class BlockFace : char {
   kNorth, kSouth, kEast, kWest, kTop, kBottom
 };
 
+// Layers of the block texture array, in the order the textures are loaded
+enum class BlockTexture : uint8_t {
+  kDirt, kGrass, kGrassSide, kLog, kLogSide, kLeaves1, kLeaves2, kLeaves3, kLeavesOpaque, kBasalt, kAndesite,
+  kLimestone, kRhyolite,
+  kCount
+};
+
+struct BlockInfo {
+  Block block;
+  bool solid;         // Hides the faces of blocks next to it
+  bool transparent;   // Lets light through
+  uint8_t light_emission; // Block light given off, 0 to ChunkLight::kMaxLight
+  BlockTexture textures[6]; // Indexed by BlockFace
+};
+
+// Every block's properties, looked up by table so the mesher and lighter's inner loops are plain loads. A new block
+// type needs only a value in Block and a row here
 namespace BlockProps {
 
-bool IsSolid(Block b);
+constexpr BlockInfo kBlockInfo[] = {
+  // block             solid  transparent light   north                    south                    east                     west                     top                  bottom
+  { Block::kUndefined, false, true,       0, { BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt      } },
+  { Block::kAir,       false, true,       0, { BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt      } },
+  { Block::kDirt,      true,  false,      0, { BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt,      BlockTexture::kDirt      } },
+  { Block::kLimestone, true,  false,      0, { BlockTexture::kLimestone, BlockTexture::kLimestone, BlockTexture::kLimestone, BlockTexture::kLimestone, BlockTexture::kLimestone, BlockTexture::kLimestone } },
+  { Block::kBasalt,    true,  false,      0, { BlockTexture::kBasalt,    BlockTexture::kBasalt,    BlockTexture::kBasalt,    BlockTexture::kBasalt,    BlockTexture::kBasalt,    BlockTexture::kBasalt    } },
+  { Block::kGrass,     true,  false,      0, { BlockTexture::kGrassSide, BlockTexture::kGrassSide, BlockTexture::kGrassSide, BlockTexture::kGrassSide, BlockTexture::kGrass,     BlockTexture::kDirt      } },
+};
+
+constexpr bool RowsMatchBlocks() {
+  for (int i = 0; i < (int)Block::kCount; ++i) {
+    if ((int)kBlockInfo[i].block != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(sizeof(kBlockInfo) / sizeof(kBlockInfo[0]) == (size_t)Block::kCount, "Every block needs a row in kBlockInfo");
+static_assert(RowsMatchBlocks(), "kBlockInfo rows must be in the same order as Block");
+
+constexpr const BlockInfo& Get(Block b) { return kBlockInfo[(int)b]; }
 
-float GetTextureIndex(Block b, BlockFace f);
+constexpr bool IsSolid(Block b) { return Get(b).solid; }
+constexpr bool IsTransparent(Block b) { return Get(b).transparent; }
+constexpr int GetLightEmission(Block b) { return Get(b).light_emission; }
+constexpr int GetTextureIndex(Block b, BlockFace f) { return (int)Get(b).textures[(int)f]; }
 
 }
@@ -7,6 +7,8 @@
 #include "control_settings.hpp"
 #include "key_bindings.hpp"
 
+const float kFarPlane = 4000.0f; // Past the outermost LOD ring at the default view distance
+
 Camera::Camera(std::shared_ptr<cl::Window>& window) {
   auto recalc_projection = [&](){ CalculateProjection(window->GetAspectRatio()); };
   window->SetResizeCallback(recalc_projection);
@@ -24,6 +26,11 @@ Camera::Camera(std::shared_ptr<cl::Window>& window) {
 }
 
 void Camera::UploadTo(std::shared_ptr<cl::Shader>& shader) {
+  Recalculate();
+  shader->UploadUniform("u_viewprojection", &cached_vpmatrix_);
+}
+
+void Camera::Recalculate() {
   if (flag_recalc_) {
     view_ = glm::rotate(glm::mat4(1.0f), rot_.y, glm::vec3(1.0f, 0.0f, 0.0f));
     view_ = glm::rotate(view_, rot_.x, glm::vec3(0.0f, 1.0f, 0.0f));
@@ -31,11 +38,15 @@ void Camera::UploadTo(std::shared_ptr<cl::Shader>& shader) {
     flag_recalc_ = false;
     cached_vpmatrix_ = proj_ * view_;
   }
-  shader->UploadUniform("u_viewprojection", &cached_vpmatrix_);
+}
+
+glm::vec3 Camera::GetForward() const {
+  // The third row of the view rotation is the camera's backward axis in world space
+  return glm::vec3(-view_[0][2], -view_[1][2], -view_[2][2]);
 }
 
 void Camera::CalculateProjection(float aspect_ratio) {
-  proj_ = glm::perspective(glm::radians(ControlSettings::camera_fov), aspect_ratio, 0.1f, 1000.0f);
+  proj_ = glm::perspective(glm::radians(ControlSettings::camera_fov), aspect_ratio, 0.1f, kFarPlane);
   flag_recalc_ = true;
 }
 
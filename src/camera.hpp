@@ -20,6 +20,15 @@ public:
 
   void FreeControl(std::shared_ptr<cl::Window>& window);
 
+  // Recomputes the view and projection matrices if anything has changed. Called by UploadTo, so the getters below
+  // are up to date for the rest of the frame after the camera has been uploaded
+  void Recalculate();
+
+  // pos_ is the view translation, so the eye sits at its negation
+  inline glm::vec3 GetEyePosition() const { return -pos_; }
+  glm::vec3 GetForward() const;
+  inline const glm::mat4& GetViewProjection() const { return cached_vpmatrix_; }
+
 private:
   bool flag_recalc_ = true;
   
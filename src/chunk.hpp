@@ -1,39 +1,93 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
-
-#include <calcium.hpp>
+#include <utility>
 
 #include "block.hpp"
+#include "chunk_connectivity.hpp"
 #include "chunk_constants.hpp"
+#include "chunk_light.hpp"
+#include "chunk_storage.hpp"
+#include "slab_allocator.hpp"
 
 class World;
 
 class Chunk {
 public:
-  Chunk(World* world, int chunk_x, int chunk_y, int chunk_z, std::shared_ptr<cl::Context> context);
-  ~Chunk();
+  Chunk(int chunk_x, int chunk_y, int chunk_z, ChunkStorage&& blocks);
+
+  // Chunks come and go as the camera moves, so they are recycled through a slab allocator rather than the heap
+  static void* operator new(size_t size) { return SlabAllocator::ForSize(size).Allocate(); }
+  static void operator delete(void* chunk, size_t size) { SlabAllocator::ForSize(size).Free(chunk); }
+
+  // Pure CPU work, safe to call from worker threads
+  static ChunkStorage GenerateBlocks(World* world, int chunk_x, int chunk_y, int chunk_z);
+
+  // Mesh builds are versioned so that a stale build finishing late never replaces a newer one. Versions are only
+  // meaningful within one chunk instance - a chunk unloaded and loaded again gets a new instance id
+  inline uint32_t GetInstanceId() const { return instance_id_; }
+  inline uint32_t NextMeshVersion() { return ++requested_mesh_version_; }
+  inline bool IsMeshRequested() const { return requested_mesh_version_ != 0; }
+  inline uint32_t GetUploadedMeshVersion() const { return uploaded_mesh_version_; }
+
+  // Records that the mesh with this version is the one now held in the world's mesh pool
+  inline void SetUploadedMeshVersion(uint32_t version) { uploaded_mesh_version_ = version; }
 
-  void Render() const;
-  void RecreateMesh();
+  // Light is computed on the workers and versioned like meshes. A chunk has no light until the first result arrives,
+  // and isn't meshed before then
+  inline uint32_t NextLightVersion() { return ++requested_light_version_; }
+  inline uint32_t GetRequestedLightVersion() const { return requested_light_version_; }
+  inline bool HasLight() const { return has_light_; }
+  inline const ChunkLight& GetLight() const { return light_; }
+  inline void SetLight(ChunkLight light) { light_ = std::move(light); has_light_ = true; }
+
+  // Which faces see through to which, updated each time the chunk is meshed. Until then every face sees through
+  inline const ChunkConnectivity& GetConnectivity() const { return connectivity_; }
+  inline void SetConnectivity(const ChunkConnectivity& connectivity) { connectivity_ = connectivity; }
+
+  // Scratch for ChunkOcclusionCuller, only meaningful while search matches the culler's current search
+  struct OcclusionState {
+    uint32_t search = 0;
+    uint8_t entered_faces = 0;
+    bool reached = false;
+  };
+  inline OcclusionState& GetOcclusionState() { return occlusion_; }
 
   inline int GetX() const { return chunk_x_; }
   inline int GetY() const { return chunk_y_; }
   inline int GetZ() const { return chunk_z_; }
 
-  inline Block GetBlockAt(int x, int y, int z) const { return blocks_[x + y * ChunkConstants::kChunkSize + z * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize]; };
+  inline Block GetBlockAt(int x, int y, int z) const { return blocks_.Get(x, y, z); };
+  inline const ChunkStorage& GetBlocks() const { return blocks_; }
 
-private:
-  void CreateMesh();
-  void DestroyMesh();
+  // Changes a block without remeshing, see World::SetBlockAt
+  inline void SetBlockAt(int x, int y, int z, Block b) { blocks_.Set(x, y, z, b); is_modified_ = true; }
+  // True if blocks have changed since the chunk was generated or loaded, so it needs saving
+  inline bool IsModified() const { return is_modified_; }
+
+  // Set while the chunk is waiting in the world's remesh queue, so it is only queued once however many edits it gets
+  inline bool IsMeshDirty() const { return is_mesh_dirty_; }
+  inline void SetMeshDirty(bool dirty) { is_mesh_dirty_ = dirty; }
+
+  // As IsMeshDirty, for the world's relight queue
+  inline bool IsLightDirty() const { return is_light_dirty_; }
+  inline void SetLightDirty(bool dirty) { is_light_dirty_ = dirty; }
 
 private:
-  World* world_;
-  Block* blocks_;
+  ChunkStorage blocks_;
+  ChunkLight light_;
+  ChunkConnectivity connectivity_ = ChunkConnectivity::All();
+  OcclusionState occlusion_;
   int chunk_x_, chunk_y_, chunk_z_;
 
-  bool is_loaded_ = false;
+  uint32_t instance_id_;
+  uint32_t requested_mesh_version_ = 0;
+  uint32_t uploaded_mesh_version_ = 0;
+  uint32_t requested_light_version_ = 0;
+  bool has_light_ = false;
 
-  std::shared_ptr<cl::Context> context_;
-  std::shared_ptr<cl::Mesh> mesh_;
+  bool is_modified_ = false;
+  bool is_mesh_dirty_ = false;
+  bool is_light_dirty_ = false;
 };
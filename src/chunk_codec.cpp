@@ -0,0 +1,114 @@
+#include "chunk_codec.hpp"
+
+#include "chunk_constants.hpp"
+
+const uint8_t kFormatVersion = 1;
+const size_t kNumBlocks = ChunkConstants::kChunkSize * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize;
+const size_t kMaxPaletteSize = 256;
+
+static void WriteVarint(uint32_t value, std::vector<uint8_t>& out) {
+  while (value >= 0x80) {
+    out.push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back((uint8_t)value);
+}
+
+static bool ReadVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 32; shift += 7) {
+    if (data == end) {
+      return false;
+    }
+    uint8_t byte = *data++;
+    value |= (uint32_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace ChunkCodec {
+
+void Encode(const Block* blocks, std::vector<uint8_t>& out) {
+  // Palette index of each block value, or -1 if not yet seen
+  int palette_index[kMaxPaletteSize];
+  for (int& index : palette_index) {
+    index = -1;
+  }
+  uint8_t palette[kMaxPaletteSize];
+  size_t palette_size = 0;
+
+  for (size_t i = 0; i < kNumBlocks; ++i) {
+    uint8_t value = (uint8_t)blocks[i];
+    if (palette_index[value] < 0) {
+      palette_index[value] = (int)palette_size;
+      palette[palette_size++] = value;
+    }
+  }
+
+  out.clear();
+  out.push_back(kFormatVersion);
+  out.push_back((uint8_t)(palette_size - 1));
+  out.insert(out.end(), palette, palette + palette_size);
+
+  for (size_t i = 0; i < kNumBlocks;) {
+    Block b = blocks[i];
+    size_t run = 1;
+    while (i + run < kNumBlocks && blocks[i + run] == b) {
+      ++run;
+    }
+    WriteVarint((uint32_t)run, out);
+    // A single entry palette needs no indices at all
+    if (palette_size > 1) {
+      out.push_back((uint8_t)palette_index[(uint8_t)b]);
+    }
+    i += run;
+  }
+}
+
+bool Decode(const uint8_t* data, size_t size, Block* blocks) {
+  const uint8_t* end = data + size;
+  if (size < 3 || data[0] != kFormatVersion) {
+    return false;
+  }
+
+  size_t palette_size = (size_t)data[1] + 1;
+  data += 2;
+  if ((size_t)(end - data) < palette_size) {
+    return false;
+  }
+  const uint8_t* palette = data;
+  data += palette_size;
+  // Blocks index the BlockProps tables, so one this build doesn't know can't be let in
+  for (size_t i = 0; i < palette_size; ++i) {
+    if (palette[i] >= (uint8_t)Block::kCount) {
+      return false;
+    }
+  }
+
+  size_t filled = 0;
+  while (filled < kNumBlocks) {
+    uint32_t run;
+    if (!ReadVarint(data, end, run) || run == 0 || run > kNumBlocks - filled) {
+      return false;
+    }
+
+    uint8_t index = 0;
+    if (palette_size > 1) {
+      if (data == end || *data >= palette_size) {
+        return false;
+      }
+      index = *data++;
+    }
+
+    Block b = (Block)palette[index];
+    for (uint32_t i = 0; i < run; ++i) {
+      blocks[filled++] = b;
+    }
+  }
+  return data == end;
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "block.hpp"
+
+// Compact serialised form of a chunk's blocks for storage on disk. The distinct blocks in the chunk are collected into
+// a palette, then the blocks are written in storage order as runs of (length, palette index). Generated chunks are
+// mostly long runs of air or stone, so they shrink to a handful of bytes.
+namespace ChunkCodec {
+
+void Encode(const Block* blocks, std::vector<uint8_t>& out);
+
+// Returns false if data is not a valid encoded chunk or holds an unknown block, in which case blocks is left in an
+// unspecified state
+bool Decode(const uint8_t* data, size_t size, Block* blocks);
+
+}
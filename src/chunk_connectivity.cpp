@@ -0,0 +1,76 @@
+#include "chunk_connectivity.hpp"
+
+#include "block.hpp"
+#include "chunk_constants.hpp"
+#include "chunk_storage.hpp"
+
+ChunkConnectivity ChunkConnectivity::Compute(const ChunkSnapshot& snapshot) {
+  const int kSize = ChunkConstants::kChunkSize;
+  const int kLast = kSize - 1;
+  const int kStep[3] = { 1, kSize, kSize * kSize }; // Index step along each axis, in ChunkStorage order
+
+  // Open blocks not yet reached by a fill, in ChunkStorage order
+  bool open[ChunkStorage::kNumBlocks];
+  int num_open = 0;
+  for (int z = 0; z < kSize; ++z) {
+    for (int y = 0; y < kSize; ++y) {
+      for (int x = 0; x < kSize; ++x) {
+        bool is_open = !BlockProps::IsSolid(snapshot.GetBlockAt(x, y, z));
+        open[ChunkStorage::Index(x, y, z)] = is_open;
+        num_open += is_open;
+      }
+    }
+  }
+  if (num_open == 0) {
+    return None();
+  }
+  if (num_open == ChunkStorage::kNumBlocks) {
+    return All();
+  }
+
+  ChunkConnectivity connectivity;
+  uint16_t stack[ChunkStorage::kNumBlocks];
+  for (int start = 0; start < ChunkStorage::kNumBlocks; ++start) {
+    if (!open[start]) {
+      continue;
+    }
+
+    // Each pocket of open blocks joins every face it touches to every other
+    int faces = 0;
+    int stack_size = 0;
+    stack[stack_size++] = (uint16_t)start;
+    open[start] = false;
+    while (stack_size > 0) {
+      int index = stack[--stack_size];
+      const int pos[3] = { index % kSize, (index / kSize) % kSize, index / (kSize * kSize) };
+      for (int axis = 0; axis < 3; ++axis) {
+        if (pos[axis] == 0) {
+          faces |= 1 << (axis * 2);
+        }
+        else if (open[index - kStep[axis]]) {
+          open[index - kStep[axis]] = false;
+          stack[stack_size++] = (uint16_t)(index - kStep[axis]);
+        }
+        if (pos[axis] == kLast) {
+          faces |= 1 << (axis * 2 + 1);
+        }
+        else if (open[index + kStep[axis]]) {
+          open[index + kStep[axis]] = false;
+          stack[stack_size++] = (uint16_t)(index + kStep[axis]);
+        }
+      }
+    }
+
+    for (int a = 0; a < kNumFaces; ++a) {
+      for (int b = 0; b < kNumFaces; ++b) {
+        if ((faces >> a) & (faces >> b) & 1) {
+          connectivity.Connect(a, b);
+        }
+      }
+    }
+    if (connectivity == All()) {
+      break;
+    }
+  }
+  return connectivity;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+#include "chunk_snapshot.hpp"
+
+// Which pairs of a chunk's six faces are joined by a path through its non-solid blocks, so that looking in through one
+// face could show something through the other. Faces are numbered axis * 2 + side, with side 0 facing -axis and side 1
+// facing +axis. Used by ChunkOcclusionCuller to stop at walls of terrain
+class ChunkConnectivity {
+public:
+  static constexpr int kNumFaces = 6;
+
+  static constexpr int Opposite(int face) { return face ^ 1; }
+
+  // Every face seeing through to every other, as for a chunk of air or one not yet meshed
+  static constexpr ChunkConnectivity All() { return ChunkConnectivity((1ull << (kNumFaces * kNumFaces)) - 1); }
+  static constexpr ChunkConnectivity None() { return ChunkConnectivity(0); }
+
+  // Flood fills the non-solid blocks of the chunk at the centre of the snapshot. Pure CPU work, safe to call from
+  // worker threads
+  static ChunkConnectivity Compute(const ChunkSnapshot& snapshot);
+
+  constexpr ChunkConnectivity() = default;
+
+  inline bool Connects(int from, int to) const { return (bits_ >> (from * kNumFaces + to)) & 1; }
+  inline void Connect(int a, int b) { bits_ |= (1ull << (a * kNumFaces + b)) | (1ull << (b * kNumFaces + a)); }
+
+  inline bool operator==(const ChunkConnectivity& other) const { return bits_ == other.bits_; }
+  inline bool operator!=(const ChunkConnectivity& other) const { return bits_ != other.bits_; }
+
+private:
+  explicit constexpr ChunkConnectivity(uint64_t bits) : bits_(bits) {}
+
+  uint64_t bits_ = 0; // Bit from * kNumFaces + to, kept symmetric
+};
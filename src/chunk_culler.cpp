@@ -0,0 +1,96 @@
+#include "chunk_culler.hpp"
+
+#include <cmath>
+
+#include "chunk.hpp"
+#include "chunk_constants.hpp"
+
+const size_t kMaxSpareGroups = 64;
+
+static inline int GroupOf(int chunk_coord) {
+  return (int)std::floor((float)chunk_coord / ChunkCuller::kGroupSize);
+}
+
+void ChunkCuller::Add(Chunk* chunk) {
+  int group_x = GroupOf(chunk->GetX()), group_y = GroupOf(chunk->GetY()), group_z = GroupOf(chunk->GetZ());
+  Group* group = groups_.Find(group_x, group_y, group_z);
+  if (!group) {
+    // Groups emptied by unloading are kept for reuse, along with their arrays
+    Group added;
+    if (!spare_groups_.empty()) {
+      added = std::move(spare_groups_.back());
+      spare_groups_.pop_back();
+    }
+    group = &groups_.Insert(group_x, group_y, group_z, std::move(added));
+    group->group_x = group_x;
+    group->group_y = group_y;
+    group->group_z = group_z;
+  }
+
+  group->chunks.push_back(chunk);
+  group->xs.push_back((float)(chunk->GetX() * ChunkConstants::kChunkSize * scale_));
+  group->ys.push_back((float)(chunk->GetY() * ChunkConstants::kChunkSize * scale_));
+  group->zs.push_back((float)(chunk->GetZ() * ChunkConstants::kChunkSize * scale_));
+}
+
+void ChunkCuller::Remove(Chunk* chunk) {
+  int group_x = GroupOf(chunk->GetX()), group_y = GroupOf(chunk->GetY()), group_z = GroupOf(chunk->GetZ());
+  Group* group = groups_.Find(group_x, group_y, group_z);
+  if (!group) {
+    return;
+  }
+
+  for (size_t i = 0; i < group->chunks.size(); ++i) {
+    if (group->chunks[i] == chunk) {
+      group->chunks[i] = group->chunks.back(); group->chunks.pop_back();
+      group->xs[i] = group->xs.back();         group->xs.pop_back();
+      group->ys[i] = group->ys.back();         group->ys.pop_back();
+      group->zs[i] = group->zs.back();         group->zs.pop_back();
+      break;
+    }
+  }
+
+  if (group->chunks.empty()) {
+    if (spare_groups_.size() < kMaxSpareGroups) {
+      spare_groups_.push_back(std::move(*group));
+    }
+    groups_.Erase(group_x, group_y, group_z);
+  }
+}
+
+void ChunkCuller::Cull(const Frustum& frustum, bool hierarchical, std::vector<Chunk*>& visible) {
+  const float kChunkSize = (float)(ChunkConstants::kChunkSize * scale_);
+  const float kGroupExtent = kChunkSize * kGroupSize;
+
+  visible.clear();
+  stats_ = Stats();
+
+  groups_.ForEach([&](const Group& group){
+    if (hierarchical) {
+      ++stats_.groups_tested;
+      glm::vec3 min(group.group_x * kGroupExtent, group.group_y * kGroupExtent, group.group_z * kGroupExtent);
+      Containment containment = frustum.ClassifyBox(min, min + glm::vec3(kGroupExtent));
+      if (containment == Containment::kOutside) {
+        ++stats_.groups_rejected;
+        return;
+      }
+      if (containment == Containment::kInside) {
+        visible.insert(visible.end(), group.chunks.begin(), group.chunks.end());
+        stats_.chunks_visible += group.chunks.size();
+        return;
+      }
+    }
+
+    size_t count = group.chunks.size();
+    visible_scratch_.resize(count);
+    frustum.CullCubes(group.xs.data(), group.ys.data(), group.zs.data(), count, kChunkSize, visible_scratch_.data());
+    stats_.chunks_tested += count;
+
+    for (size_t i = 0; i < count; ++i) {
+      if (visible_scratch_[i]) {
+        visible.push_back(group.chunks[i]);
+        ++stats_.chunks_visible;
+      }
+    }
+  });
+}
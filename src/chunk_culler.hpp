@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "chunk_map.hpp"
+#include "frustum.hpp"
+
+class Chunk;
+
+// Keeps loaded chunks bucketed into groups of kGroupSize^3 neighbouring chunks for frustum culling. Each group stores
+// the origins of its chunks as separate x, y and z arrays so they can be tested several at a time. With hierarchical
+// culling a group's bounds are tested first, and groups found entirely outside or inside the frustum skip the per
+// chunk tests. A culler built with a scale above 1 holds ChunkLod nodes, each spanning scale chunks along every side
+class ChunkCuller {
+public:
+  static constexpr int kGroupSize = 4;
+
+  ChunkCuller(int scale = 1) : scale_(scale) {}
+
+  struct Stats {
+    size_t groups_tested   = 0;
+    size_t groups_rejected = 0;
+    size_t chunks_tested   = 0;
+    size_t chunks_visible  = 0;
+  };
+
+  void Add(Chunk* chunk);
+  void Remove(Chunk* chunk);
+
+  // Replaces the contents of visible with every chunk at least partly inside the frustum
+  void Cull(const Frustum& frustum, bool hierarchical, std::vector<Chunk*>& visible);
+
+  inline const Stats& GetStats() const { return stats_; }
+
+private:
+  struct Group {
+    int group_x = 0, group_y = 0, group_z = 0;
+    std::vector<Chunk*> chunks;
+    std::vector<float> xs, ys, zs; // minimum corner of each chunk in world space
+  };
+
+  ChunkMap<Group> groups_;
+  std::vector<Group> spare_groups_;
+  std::vector<uint8_t> visible_scratch_;
+  Stats stats_;
+  int scale_;
+};
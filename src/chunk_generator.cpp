@@ -1,11 +1,17 @@
 #include "chunk_generator.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <stdlib.h>
-#include <simplex.h>
+#include <limits>
+#include <memory>
+#include <mutex>
 
 #include "chunk.hpp"
 #include "chunk_constants.hpp"
+#include "chunk_map.hpp"
+#include "ring_queue.hpp"
+#include "simplex_noise.hpp"
+#include "slab_allocator.hpp"
 #include "world.hpp"
 
 const float kGradientSampleDistance = 0.01f; // Rate at which foothills transition to mountains. Smaller number = smoother gradients
@@ -13,48 +19,127 @@ const float kMountainHeight = 10.0f;         // Maximum height/depth of terrain
 const float kDirtDepth = 4.0f;               // Average depth of the top layer of dirt and grass before transitioning to stone
 const float kDirtDepthSampleDistance = 0.2f; // Rate at which dirt depth varies. Smaller = smoother transitions
 
-namespace ChunkGenerator {
+const size_t kMaxCachedColumns = 1024;       // Comfortably more than the columns within view distance
 
-Block* GenerateChunk(World* world, int chunk_x, int chunk_y, int chunk_z) {
-  Block* blocks = new Block[ChunkConstants::kChunkSize * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize];
+// Everything about the terrain that depends only on x and z, sampled once for a column of chunks
+struct TerrainColumn {
+  float surface_height[ChunkConstants::kChunkSize * ChunkConstants::kChunkSize]; // Indexed x + z * kChunkSize
+  float dirt_depth[ChunkConstants::kChunkSize * ChunkConstants::kChunkSize];
 
-  for (int x = 0; x < ChunkConstants::kChunkSize; ++x) {
-    float block_x = chunk_x * (float)ChunkConstants::kChunkSize + x;
+  // Blocks above min_surface in every column are air, and blocks at or below stone_top in every column are stone
+  float min_surface;
+  float stone_top;
+};
 
-    for (int y = 0; y < ChunkConstants::kChunkSize; ++y) {
-    float block_y = chunk_y * (float)ChunkConstants::kChunkSize + y;
+// Chunks are generated in vertical stacks around the camera, so the column is usually already cached by the chunk
+// above or below. Columns are evicted oldest first
+static std::mutex column_cache_mutex;
+static ChunkMap<std::shared_ptr<const TerrainColumn>> column_cache;
+static RingQueue<std::pair<int, int>> column_cache_order;
+
+static std::shared_ptr<const TerrainColumn> SampleColumn(int chunk_x, int chunk_z) {
+  const int kNumColumns = ChunkConstants::kChunkSize * ChunkConstants::kChunkSize;
+
+  // Every sample point of the chunk's columns, handed to the noise in one batch so it can take them four at a time
+  float sample_x[kNumColumns], sample_z[kNumColumns], dirt_layer[kNumColumns];
+  for (int z = 0; z < ChunkConstants::kChunkSize; ++z) {
+    for (int x = 0; x < ChunkConstants::kChunkSize; ++x) {
+      int index = x + z * ChunkConstants::kChunkSize;
+      sample_x[index] = (chunk_x * (float)ChunkConstants::kChunkSize + x) * kGradientSampleDistance;
+      sample_z[index] = (chunk_z * (float)ChunkConstants::kChunkSize + z) * kGradientSampleDistance;
+      dirt_layer[index] = 967.15f;
+    }
+  }
+
+  auto column = std::allocate_shared<TerrainColumn>(SlabStlAllocator<TerrainColumn>());
+  SimplexNoise::Noise2d(sample_x, sample_z, kNumColumns, column->surface_height);
+  SimplexNoise::Noise3d(sample_x, sample_z, dirt_layer, kNumColumns, column->dirt_depth);
+
+  column->min_surface = std::numeric_limits<float>::max();
+  column->stone_top = std::numeric_limits<float>::lowest();
+  for (int index = 0; index < kNumColumns; ++index) {
+    column->surface_height[index] *= kMountainHeight;
+    column->dirt_depth[index] = std::fabs(column->dirt_depth[index] + 0.9f) * kDirtDepth;
+
+    // The same sums GenerateChunk compares against, so a chunk classified uniform is exactly what it would generate
+    float surface = column->surface_height[index];
+    column->min_surface = std::min(column->min_surface, surface);
+    column->stone_top = std::max(column->stone_top, std::max(surface + column->dirt_depth[index], surface + 1.0f));
+  }
+  return column;
+}
+
+static std::shared_ptr<const TerrainColumn> GetColumn(int chunk_x, int chunk_z) {
+  {
+    std::lock_guard<std::mutex> lock(column_cache_mutex);
+    const std::shared_ptr<const TerrainColumn>* cached = column_cache.Find(chunk_x, 0, chunk_z);
+    if (cached) {
+      return *cached;
+    }
+  }
 
-      for (int z = 0; z < ChunkConstants::kChunkSize; ++z) {
-        float block_z = chunk_z * (float)ChunkConstants::kChunkSize + z;
+  // Sampled outside the lock. Two threads may sample the same column, which is wasted work but gives the same result
+  std::shared_ptr<const TerrainColumn> column = SampleColumn(chunk_x, chunk_z);
 
-        int index = x + y * ChunkConstants::kChunkSize + z * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize;
+  std::lock_guard<std::mutex> lock(column_cache_mutex);
+  if (!column_cache.Find(chunk_x, 0, chunk_z)) {
+    if (column_cache.Size() >= kMaxCachedColumns) {
+      column_cache.Erase(column_cache_order.Front().first, 0, column_cache_order.Front().second);
+      column_cache_order.PopFront();
+    }
+    column_cache.Insert(chunk_x, 0, chunk_z, column);
+    column_cache_order.PushBack(std::make_pair(chunk_x, chunk_z));
+  }
+  return column;
+}
+
+namespace ChunkGenerator {
+
+void GenerateChunk(World* world, int chunk_x, int chunk_y, int chunk_z, Block* blocks) {
+  std::shared_ptr<const TerrainColumn> column = GetColumn(chunk_x, chunk_z);
+
+  // x is innermost to match the storage order, so each row of blocks is a branchless select the compiler can vectorise
+  for (int z = 0; z < ChunkConstants::kChunkSize; ++z) {
+    const float* surface_height = &column->surface_height[z * ChunkConstants::kChunkSize];
+    const float* dirt_depth = &column->dirt_depth[z * ChunkConstants::kChunkSize];
 
-        // If we are above surface height, the block must be air
-        float surface_height = (float)simplex_noise2d(block_x * kGradientSampleDistance, block_z * kGradientSampleDistance) * kMountainHeight;
-        if (block_y < surface_height) {
-          blocks[index] = Block::kAir;
-          continue;
-        }
+    for (int y = 0; y < ChunkConstants::kChunkSize; ++y) {
+      float block_y = chunk_y * (float)ChunkConstants::kChunkSize + y;
+      Block* row = &blocks[y * ChunkConstants::kChunkSize + z * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize];
 
-        // Default block type is stone
+      for (int x = 0; x < ChunkConstants::kChunkSize; ++x) {
+        // Above surface height the block must be air. Below, the top layer is grass, then dirt, then stone
         // TODO: Select stone type based on region
-        blocks[index] = Block::kBasalt;
-
-        // Replace top layer of stone with dirt
-        float dirt_depth = (float)abs(simplex_noise3d(block_x * kGradientSampleDistance, block_z * kGradientSampleDistance, 967.15f) + 0.9) * kDirtDepth;
-        if (block_y < surface_height + dirt_depth) {
-          blocks[index] = Block::kDirt;
-        }
-
-        // Replace top layer of dirt with grass
-        if (block_y < surface_height + 1.0f) {
-          blocks[index] = Block::kGrass;
-        }
+        Block b = Block::kBasalt;
+        b = block_y < surface_height[x] + dirt_depth[x] ? Block::kDirt : b;
+        b = block_y < surface_height[x] + 1.0f ? Block::kGrass : b;
+        b = block_y < surface_height[x] ? Block::kAir : b;
+        row[x] = b;
       }
     }
   }
+}
+
+bool GetUniformBlock(int chunk_x, int chunk_y, int chunk_z, Block& uniform) {
+  std::shared_ptr<const TerrainColumn> column = GetColumn(chunk_x, chunk_z);
+  float lowest_y = chunk_y * (float)ChunkConstants::kChunkSize;
+  float highest_y = lowest_y + (ChunkConstants::kChunkSize - 1);
+
+  if (highest_y < column->min_surface) {
+    uniform = Block::kAir;
+    return true;
+  }
+  if (lowest_y >= column->stone_top) {
+    uniform = Block::kBasalt;
+    return true;
+  }
+  return false;
+}
 
-  return blocks;
+void ClearColumnCache() {
+  std::lock_guard<std::mutex> lock(column_cache_mutex);
+  column_cache.Clear();
+  column_cache_order.Clear();
 }
 
 }
@@ -6,6 +6,16 @@ class World;
 
 namespace ChunkGenerator {
 
-Block* GenerateChunk(World* world, int chunk_x, int chunk_y, int chunk_z);
+// Writes the chunk's blocks in storage order into a caller's buffer of ChunkStorage::kNumBlocks blocks, so nothing is
+// allocated. Safe to call from several threads at once
+void GenerateChunk(World* world, int chunk_x, int chunk_y, int chunk_z, Block* blocks);
+
+// Returns true and sets uniform if every block of the chunk is the same, as it is for chunks wholly above or below the
+// surface. Decided from the height range of the chunk's terrain column without generating any blocks. Safe to call
+// from several threads at once
+bool GetUniformBlock(int chunk_x, int chunk_y, int chunk_z, Block& uniform);
+
+// Forgets the cached terrain columns, so the next chunk in every column samples the noise again
+void ClearColumnCache();
 
 }
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "chunk_constants.hpp"
+#include "chunk_storage.hpp"
+#include "slab_allocator.hpp"
+
+// Sky light and block light for every block of a chunk, each 0 to kMaxLight, packed into one byte per block with sky
+// light in the high four bits. Stored in the same order as ChunkStorage. The sky is towards -y, which is up on screen.
+// Like ChunkStorage, a chunk lit the same throughout, as open air under the sky or solid rock is, keeps one value and
+// only gets an array from the slab allocator once its light varies
+class ChunkLight {
+public:
+  static constexpr int kMaxLight = 15;
+
+  static constexpr uint8_t Pack(int sky, int block) { return (uint8_t)((sky << 4) | block); }
+  static constexpr int Sky(uint8_t packed) { return packed >> 4; }
+  static constexpr int BlockLight(uint8_t packed) { return packed & 0xf; }
+
+  explicit ChunkLight(uint8_t packed = 0) : uniform_(packed) {}
+
+  inline uint8_t Get(int index) const { return dense_.empty() ? uniform_ : dense_[index]; }
+  inline uint8_t Get(int x, int y, int z) const { return Get(ChunkStorage::Index(x, y, z)); }
+
+  // Gives a uniform chunk its array the first time a value differs. Assign picks the form again
+  inline void Set(int index, uint8_t packed) {
+    if (dense_.empty()) {
+      if (packed == uniform_) {
+        return;
+      }
+      dense_.assign(ChunkStorage::kNumBlocks, uniform_);
+    }
+    dense_[index] = packed;
+  }
+
+  // Replaces every value with kNumBlocks values in storage order, dropping the array if they are all the same
+  void Assign(const uint8_t* values) {
+    bool uniform = true;
+    for (int i = 1; i < ChunkStorage::kNumBlocks && uniform; ++i) {
+      uniform = values[i] == values[0];
+    }
+    if (uniform) {
+      uniform_ = values[0];
+      dense_.clear();
+      dense_.shrink_to_fit();
+    } else {
+      dense_.assign(values, values + ChunkStorage::kNumBlocks);
+    }
+  }
+
+  inline bool IsUniform() const { return dense_.empty(); }
+
+  bool Equals(const ChunkLight& other) const {
+    if (IsUniform() && other.IsUniform()) {
+      return uniform_ == other.uniform_;
+    }
+    if (!IsUniform() && !other.IsUniform()) {
+      return std::memcmp(dense_.data(), other.dense_.data(), ChunkStorage::kNumBlocks) == 0;
+    }
+    for (int i = 0; i < ChunkStorage::kNumBlocks; ++i) {
+      if (Get(i) != other.Get(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // True if the layer of blocks at the low (side 0) or high (side 1) end of axis matches other's. Only a changed
+  // border can change the light of a neighbouring chunk
+  bool BorderEquals(const ChunkLight& other, int axis, int side) const {
+    if (IsUniform() && other.IsUniform()) {
+      return uniform_ == other.uniform_;
+    }
+    const int kSize = ChunkConstants::kChunkSize;
+    int layer = side == 0 ? 0 : kSize - 1;
+    for (int i = 0; i < kSize; ++i) {
+      for (int j = 0; j < kSize; ++j) {
+        int pos[3];
+        pos[axis] = layer;
+        pos[(axis + 1) % 3] = i;
+        pos[(axis + 2) % 3] = j;
+        int index = ChunkStorage::Index(pos[0], pos[1], pos[2]);
+        if (Get(index) != other.Get(index)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Includes the light object itself, for comparing against the kNumBlocks bytes of a plain array
+  size_t GetMemoryUsage() const { return sizeof(*this) + dense_.capacity(); }
+
+private:
+  uint8_t uniform_;
+  SlabVector<uint8_t> dense_;
+};
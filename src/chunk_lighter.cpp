@@ -0,0 +1,98 @@
+#include "chunk_lighter.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "block.hpp"
+#include "chunk_constants.hpp"
+
+const int kPadded = ChunkSnapshot::kPaddedSize;
+const int kNumPaddedBlocks = kPadded * kPadded * kPadded;
+
+// Index steps to the six neighbours of a padded block. +y is the direction sky light falls
+const int kSteps[6] = { 1, -1, kPadded, -kPadded, kPadded * kPadded, -kPadded * kPadded };
+const int kDownStep = kPadded;
+
+enum class LightChannel { kSky, kBlock };
+
+struct InsideTable {
+  bool inside[kNumPaddedBlocks];
+
+  InsideTable() {
+    for (int i = 0; i < kNumPaddedBlocks; ++i) {
+      int x = i % kPadded, y = (i / kPadded) % kPadded, z = i / (kPadded * kPadded);
+      inside[i] = x > 0 && x < kPadded - 1 && y > 0 && y < kPadded - 1 && z > 0 && z < kPadded - 1;
+    }
+  }
+};
+
+// Which padded blocks belong to the chunk rather than its border
+static const InsideTable kInside;
+
+// Flood fills one channel of levels, which starts out holding the border light and the light emitted inside. Blocks
+// are queued by level and the brightest are spread first, so every block is spread from once, at its final level
+static void Propagate(const ChunkSnapshot& snapshot, LightChannel channel, uint8_t* levels) {
+  thread_local std::vector<uint16_t> queues[ChunkLight::kMaxLight + 1];
+
+  for (int i = 0; i < kNumPaddedBlocks; ++i) {
+    if (levels[i] > 1) {
+      queues[levels[i]].push_back((uint16_t)i);
+    }
+  }
+
+  for (int level = ChunkLight::kMaxLight; level > 1; --level) {
+    std::vector<uint16_t>& queue = queues[level];
+    // Full sky light falling straight down joins the queue being walked, so it is read by index
+    for (size_t i = 0; i < queue.size(); ++i) {
+      int index = queue[i];
+      if (levels[index] != level) {
+        continue; // Raised again after it was queued, and spread from at the higher level
+      }
+
+      for (int step : kSteps) {
+        int next = index + step;
+        if (next < 0 || next >= kNumPaddedBlocks || !kInside.inside[next] || !BlockProps::IsTransparent(snapshot.blocks[next])) {
+          continue;
+        }
+        int next_level = channel == LightChannel::kSky && step == kDownStep && level == ChunkLight::kMaxLight ? level : level - 1;
+        if (next_level > levels[next]) {
+          levels[next] = (uint8_t)next_level;
+          queues[next_level].push_back((uint16_t)next);
+        }
+      }
+    }
+    queue.clear();
+  }
+  queues[0].clear();
+  queues[1].clear();
+}
+
+namespace ChunkLighter {
+
+void ComputeLight(const ChunkSnapshot& snapshot, ChunkLight& light) {
+  const int kSize = ChunkConstants::kChunkSize;
+
+  uint8_t sky[kNumPaddedBlocks];
+  uint8_t block[kNumPaddedBlocks];
+  for (int i = 0; i < kNumPaddedBlocks; ++i) {
+    bool inside = kInside.inside[i];
+    sky[i] = inside ? 0 : (uint8_t)ChunkLight::Sky(snapshot.light[i]);
+    block[i] = inside ? (uint8_t)BlockProps::GetLightEmission(snapshot.blocks[i]) : (uint8_t)ChunkLight::BlockLight(snapshot.light[i]);
+  }
+
+  Propagate(snapshot, LightChannel::kSky, sky);
+  Propagate(snapshot, LightChannel::kBlock, block);
+
+  uint8_t values[ChunkStorage::kNumBlocks];
+  for (int z = 0; z < kSize; ++z) {
+    for (int y = 0; y < kSize; ++y) {
+      for (int x = 0; x < kSize; ++x) {
+        int padded = ChunkSnapshot::Index(x, y, z);
+        values[ChunkStorage::Index(x, y, z)] = ChunkLight::Pack(sky[padded], block[padded]);
+      }
+    }
+  }
+  light.Assign(values);
+}
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "chunk_light.hpp"
+#include "chunk_snapshot.hpp"
+
+namespace ChunkLighter {
+
+// Lights the chunk at the centre of the snapshot by flood filling from the light in its border and any light emitting
+// blocks inside it, brightest first so each block is spread from once. Sky light at full strength
+// carries straight down (+y) without fading, and all other light fades by one per block. The whole chunk is relit
+// each time, which at 12^3 blocks is cheaper than tracking what an edit removed. Light leaving the chunk reaches its
+// neighbours when they are relit with this chunk's new border. Pure CPU work, safe to call from worker threads
+void ComputeLight(const ChunkSnapshot& snapshot, ChunkLight& light);
+
+}
@@ -0,0 +1,102 @@
+#include "chunk_lod.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "chunk_constants.hpp"
+#include "chunk_generator.hpp"
+#include "world.hpp"
+
+const int kMaxBlockValue = 128; // Block is a char, so its values fit a small count table
+
+namespace ChunkLod {
+
+void Downsample(const Block* blocks, int scale, Block* cells) {
+  const int kSize = ChunkConstants::kChunkSize;
+  const int kSide = kSize * scale;
+  const int kHalfCell = scale * scale * scale / 2;
+  auto block_at = [&](int x, int y, int z){ return blocks[x + y * kSide + z * kSide * kSide]; };
+
+  int counts[kMaxBlockValue];
+  for (int cz = 0; cz < kSize; ++cz) {
+    for (int cy = 0; cy < kSize; ++cy) {
+      for (int cx = 0; cx < kSize; ++cx) {
+        Block& cell = cells[ChunkStorage::Index(cx, cy, cz)];
+        cell = Block::kAir;
+
+        int num_solid = 0;
+        for (int z = cz * scale; z < (cz + 1) * scale; ++z) {
+          for (int y = cy * scale; y < (cy + 1) * scale; ++y) {
+            for (int x = cx * scale; x < (cx + 1) * scale; ++x) {
+              num_solid += BlockProps::IsSolid(block_at(x, y, z)) ? 1 : 0;
+            }
+          }
+        }
+        if (num_solid < kHalfCell) {
+          continue;
+        }
+
+        // Walk down from the sky side of the cell, its lowest y, to the first layer with anything solid in it
+        for (int y = cy * scale; y < (cy + 1) * scale; ++y) {
+          std::memset(counts, 0, sizeof(counts));
+          int best = 0;
+          for (int z = cz * scale; z < (cz + 1) * scale; ++z) {
+            for (int x = cx * scale; x < (cx + 1) * scale; ++x) {
+              Block b = block_at(x, y, z);
+              if (BlockProps::IsSolid(b) && ++counts[(int)b] > best) {
+                best = counts[(int)b];
+                cell = b;
+              }
+            }
+          }
+          if (best > 0) {
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+ChunkStorage BuildNode(World* world, int level, int node_x, int node_y, int node_z) {
+  const int kSize = ChunkConstants::kChunkSize;
+  const int kScale = ScaleOf(level);
+  const int kSide = kSize * kScale;
+
+  // Up to 96^3 blocks at the coarsest level, so kept per thread rather than allocated per node
+  thread_local std::vector<Block> volume;
+  volume.resize((size_t)kSide * kSide * kSide);
+
+  Block blocks[ChunkStorage::kNumBlocks];
+  for (int dz = 0; dz < kScale; ++dz) {
+    for (int dy = 0; dy < kScale; ++dy) {
+      for (int dx = 0; dx < kScale; ++dx) {
+        int chunk_x = node_x * kScale + dx, chunk_y = node_y * kScale + dy, chunk_z = node_z * kScale + dz;
+        Block uniform;
+        if (!world || !world->GetRegionStore().LoadChunk(chunk_x, chunk_y, chunk_z, blocks)) {
+          if (ChunkGenerator::GetUniformBlock(chunk_x, chunk_y, chunk_z, uniform)) {
+            std::fill(blocks, blocks + ChunkStorage::kNumBlocks, uniform);
+          }
+          else {
+            ChunkGenerator::GenerateChunk(world, chunk_x, chunk_y, chunk_z, blocks);
+          }
+        }
+
+        // Copy the chunk into its place in the volume a row at a time
+        for (int z = 0; z < kSize; ++z) {
+          for (int y = 0; y < kSize; ++y) {
+            Block* row = &volume[(size_t)(dx * kSize) + (size_t)(dy * kSize + y) * kSide + (size_t)(dz * kSize + z) * kSide * kSide];
+            std::memcpy(row, &blocks[ChunkStorage::Index(0, y, z)], kSize * sizeof(Block));
+          }
+        }
+      }
+    }
+  }
+
+  Block cells[ChunkStorage::kNumBlocks];
+  Downsample(volume.data(), kScale, cells);
+  return ChunkStorage(cells);
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "block.hpp"
+#include "chunk_storage.hpp"
+
+class World;
+
+// Coarse stand-ins for distant chunks. A level n node covers 2^n chunks along each side and holds kChunkSize^3 cells,
+// each summarising 2^n blocks along each side, so it is stored, meshed and drawn just like a chunk and scaled up by
+// 2^n when rendered. ChunkStreamer decides which level each part of the world is drawn at.
+namespace ChunkLod {
+
+constexpr int kMaxLevels = 3; // Nodes of 2, 4 and 8 chunks a side
+
+constexpr int ScaleOf(int level) { return 1 << level; }
+
+// Reduces a cube of (kChunkSize * scale)^3 blocks, stored x fastest then y then z, to kChunkSize^3 cells. A cell is
+// solid if at least half of its blocks are, and takes the most common solid block in its layer nearest the sky (lowest
+// y) holding any, so surfaces keep their top block
+void Downsample(const Block* blocks, int scale, Block* cells);
+
+// Builds the node at node_x, node_y, node_z of level from the chunks it covers. Chunks saved in the world's region
+// store are read from there so edits show up at a distance, and the rest are generated without being stored. world
+// may be nullptr to generate everything. Safe to call from worker threads
+ChunkStorage BuildNode(World* world, int level, int node_x, int node_y, int node_z);
+
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Open addressing hash map from chunk coordinates to T, using linear probing over a flat slot array. Erasing shifts
+// later entries in the probe run back rather than leaving tombstones, so lookups never degrade as chunks stream in
+// and out. Iteration walks the slot array in memory order.
+template <typename T>
+class ChunkMap {
+public:
+  ChunkMap() : slots_(kMinCapacity) { }
+
+  // Coordinates are packed into 21 bits each, so chunks must lie within +-2^20 on every axis
+  static inline uint64_t PackKey(int chunk_x, int chunk_y, int chunk_z) {
+    return  ((uint64_t)(chunk_x & kCoordMask))
+         | (((uint64_t)(chunk_y & kCoordMask)) << 21)
+         | (((uint64_t)(chunk_z & kCoordMask)) << 42);
+  }
+
+  T* Find(int chunk_x, int chunk_y, int chunk_z) {
+    uint64_t key = PackKey(chunk_x, chunk_y, chunk_z);
+    for (size_t i = Hash(key) & Mask(); ; i = (i + 1) & Mask()) {
+      Slot& slot = slots_[i];
+      if (slot.key == key)    return &slot.value;
+      if (slot.key == kEmpty) return nullptr;
+    }
+  }
+
+  const T* Find(int chunk_x, int chunk_y, int chunk_z) const {
+    return const_cast<ChunkMap*>(this)->Find(chunk_x, chunk_y, chunk_z);
+  }
+
+  // Inserts value, replacing any existing entry at these coordinates
+  T& Insert(int chunk_x, int chunk_y, int chunk_z, T value) {
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+      Rehash(slots_.size() * 2);
+    }
+
+    uint64_t key = PackKey(chunk_x, chunk_y, chunk_z);
+    for (size_t i = Hash(key) & Mask(); ; i = (i + 1) & Mask()) {
+      Slot& slot = slots_[i];
+      if (slot.key == kEmpty) {
+        slot.key = key;
+        ++size_;
+      }
+      if (slot.key == key) {
+        slot.value = std::move(value);
+        return slot.value;
+      }
+    }
+  }
+
+  // Returns false if there was nothing to erase
+  bool Erase(int chunk_x, int chunk_y, int chunk_z) {
+    uint64_t key = PackKey(chunk_x, chunk_y, chunk_z);
+    size_t i = Hash(key) & Mask();
+    while (slots_[i].key != key) {
+      if (slots_[i].key == kEmpty) {
+        return false;
+      }
+      i = (i + 1) & Mask();
+    }
+
+    // Backward shift deletion: pull later entries of the probe run into the hole unless that would move them before
+    // their home slot
+    size_t hole = i;
+    for (size_t j = (hole + 1) & Mask(); slots_[j].key != kEmpty; j = (j + 1) & Mask()) {
+      size_t home = Hash(slots_[j].key) & Mask();
+      bool can_move = hole <= j ? (home <= hole || home > j) : (home <= hole && home > j);
+      if (can_move) {
+        slots_[hole].key = slots_[j].key;
+        slots_[hole].value = std::move(slots_[j].value);
+        hole = j;
+      }
+    }
+    slots_[hole].key = kEmpty;
+    slots_[hole].value = T();
+    --size_;
+    return true;
+  }
+
+  void Clear() {
+    for (Slot& slot : slots_) {
+      slot.key = kEmpty;
+      slot.value = T();
+    }
+    size_ = 0;
+  }
+
+  // Calls fn(value) for every entry, in slot order
+  template <typename Fn>
+  void ForEach(Fn&& fn) {
+    for (Slot& slot : slots_) {
+      if (slot.key != kEmpty) {
+        fn(slot.value);
+      }
+    }
+  }
+
+  template <typename Fn>
+  void ForEach(Fn&& fn) const {
+    for (const Slot& slot : slots_) {
+      if (slot.key != kEmpty) {
+        fn(slot.value);
+      }
+    }
+  }
+
+  inline size_t Size() const { return size_; }
+  inline bool Empty() const { return size_ == 0; }
+  inline size_t GetCapacity() const { return slots_.size(); }
+
+private:
+  static constexpr uint64_t kEmpty = ~0ull; // Never produced by PackKey, which only uses the low 63 bits
+  static constexpr uint64_t kCoordMask = (1ull << 21) - 1;
+  static constexpr size_t kMinCapacity = 64;
+
+  struct Slot {
+    uint64_t key = kEmpty;
+    T value = T();
+  };
+
+  // splitmix64 finaliser - neighbouring chunks differ only in a few low bits of each coordinate, so mix thoroughly
+  static inline size_t Hash(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return (size_t)key;
+  }
+
+  inline size_t Mask() const { return slots_.size() - 1; }
+
+  void Rehash(size_t new_capacity) {
+    std::vector<Slot> old_slots(new_capacity);
+    old_slots.swap(slots_);
+    for (Slot& slot : old_slots) {
+      if (slot.key == kEmpty) {
+        continue;
+      }
+      size_t i = Hash(slot.key) & Mask();
+      while (slots_[i].key != kEmpty) {
+        i = (i + 1) & Mask();
+      }
+      slots_[i].key = slot.key;
+      slots_[i].value = std::move(slot.value);
+    }
+  }
+
+private:
+  std::vector<Slot> slots_;
+  size_t size_ = 0;
+};
@@ -0,0 +1,236 @@
+#include "chunk_mesh_pool.hpp"
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "chunk.hpp"
+#include "chunk_constants.hpp"
+#include "chunk_vertex.hpp"
+
+const uint32_t kMinPageVertices = 4096; // Grown by doubling, so a page soon settles at the size its chunks need
+const uint32_t kMinPageIndices = 6144;
+const size_t kMaxSparePages = 8;
+
+static inline int SlotOf(int local_x, int local_y, int local_z) {
+  return local_x + local_y * ChunkMeshPool::kPageSize + local_z * ChunkMeshPool::kPageSize * ChunkMeshPool::kPageSize;
+}
+
+// The shader reads a vertex's slot straight from its page offset bits to test it against the visible mask
+static_assert((ChunkVertex::PackPageOffset(3, 2, 1) >> 16) == (uint32_t)(3 + 2 * ChunkMeshPool::kPageSize + 1 * ChunkMeshPool::kPageSize * ChunkMeshPool::kPageSize),
+  "Page offset bits must hold the chunk's slot in the page");
+static_assert(ChunkMeshPool::kPageSize * ChunkMeshPool::kPageSize * ChunkMeshPool::kPageSize <= 64,
+  "A page's visible mask holds 64 chunks");
+
+// Allocates size units, growing the allocator and the buffer it describes if no free range is large enough
+template <typename T>
+static uint32_t AllocateGrowing(RangeAllocator& ranges, std::vector<T>& buffer, size_t units_per_element, uint32_t size, uint32_t min_capacity) {
+  uint32_t offset = ranges.Allocate(size);
+  if (offset == RangeAllocator::kInvalidOffset) {
+    ranges.Grow(std::max({ min_capacity, ranges.GetCapacity() * 2, ranges.GetUsedEnd() + size }));
+    buffer.resize((size_t)ranges.GetCapacity() * units_per_element);
+    offset = ranges.Allocate(size);
+  }
+  return offset;
+}
+
+void ChunkMeshPool::Store(int chunk_x, int chunk_y, int chunk_z, const ChunkMesh& mesh) {
+  int page_x = PageOf(chunk_x), page_y = PageOf(chunk_y), page_z = PageOf(chunk_z);
+  int local_x = chunk_x - page_x * kPageSize, local_y = chunk_y - page_y * kPageSize, local_z = chunk_z - page_z * kPageSize;
+
+  std::unique_ptr<Page>* found = pages_.Find(page_x, page_y, page_z);
+  if (!found) {
+    if (mesh.indices.empty()) {
+      return;
+    }
+    // Pages emptied by unloading are kept for reuse, along with the buffers they grew
+    std::unique_ptr<Page> page;
+    if (!spare_pages_.empty()) {
+      page = std::move(spare_pages_.back());
+      spare_pages_.pop_back();
+    }
+    else {
+      page = std::make_unique<Page>();
+    }
+    page->page_x = page_x;
+    page->page_y = page_y;
+    page->page_z = page_z;
+    found = &pages_.Insert(page_x, page_y, page_z, std::move(page));
+  }
+  Page& page = **found;
+
+  Allocation& allocation = page.allocations[SlotOf(local_x, local_y, local_z)];
+  FreeAllocation(page, allocation);
+  if (!page.dirty) {
+    page.dirty = true;
+    dirty_pages_.push_back(&page);
+  }
+  if (mesh.indices.empty()) {
+    return;
+  }
+
+  allocation.num_vertices = (uint32_t)(mesh.vertices.size() / ChunkVertex::kNumFloats);
+  allocation.num_indices = (uint32_t)mesh.indices.size();
+  allocation.vertex_offset = AllocateGrowing(page.vertex_ranges, page.vertices, ChunkVertex::kNumFloats, allocation.num_vertices, kMinPageVertices);
+  allocation.index_offset = AllocateGrowing(page.index_ranges, page.indices, 1, allocation.num_indices, kMinPageIndices);
+  ++page.num_meshes;
+
+  // Tag each vertex with the chunk's place in the page, and rebase the indices onto the chunk's vertex range
+  uint32_t page_offset = ChunkVertex::PackPageOffset(local_x, local_y, local_z);
+  float* vertices = &page.vertices[(size_t)allocation.vertex_offset * ChunkVertex::kNumFloats];
+  for (size_t i = 0; i < mesh.vertices.size(); i += ChunkVertex::kNumFloats) {
+    vertices[i] = mesh.vertices[i];
+    vertices[i + 1] = (float)((uint32_t)mesh.vertices[i + 1] | page_offset);
+  }
+  uint32_t* indices = &page.indices[allocation.index_offset];
+  for (size_t i = 0; i < mesh.indices.size(); ++i) {
+    indices[i] = mesh.indices[i] + allocation.vertex_offset;
+  }
+}
+
+void ChunkMeshPool::Remove(int chunk_x, int chunk_y, int chunk_z) {
+  int page_x = PageOf(chunk_x), page_y = PageOf(chunk_y), page_z = PageOf(chunk_z);
+  std::unique_ptr<Page>* found = pages_.Find(page_x, page_y, page_z);
+  if (!found) {
+    return;
+  }
+  Page& page = **found;
+
+  Allocation& allocation = page.allocations[SlotOf(chunk_x - page_x * kPageSize, chunk_y - page_y * kPageSize, chunk_z - page_z * kPageSize)];
+  if (allocation.num_indices == 0) {
+    return;
+  }
+  FreeAllocation(page, allocation);
+  if (!page.dirty) {
+    page.dirty = true;
+    dirty_pages_.push_back(&page);
+  }
+}
+
+void ChunkMeshPool::FreeAllocation(Page& page, Allocation& allocation) {
+  if (allocation.num_indices == 0) {
+    return;
+  }
+
+  // The whole index buffer is drawn and the mask only covers live chunks, so the freed range must stop drawing.
+  // All-zero indices are degenerate triangles
+  std::fill(page.indices.begin() + allocation.index_offset, page.indices.begin() + allocation.index_offset + allocation.num_indices, 0);
+  page.vertex_ranges.Free(allocation.vertex_offset, allocation.num_vertices);
+  page.index_ranges.Free(allocation.index_offset, allocation.num_indices);
+  allocation = Allocation();
+  --page.num_meshes;
+}
+
+void ChunkMeshPool::Upload(const std::shared_ptr<cl::Context>& context) {
+  page_uploads_ = 0;
+
+  for (Page* page : dirty_pages_) {
+    page->dirty = false;
+
+    // Pages are only dropped here, so that dirty_pages_ never points at a deleted page. An empty page has every range
+    // free and every index zeroed already, so it can be handed out again as it is
+    if (page->num_meshes == 0) {
+      std::unique_ptr<Page>* found = pages_.Find(page->page_x, page->page_y, page->page_z);
+      if (spare_pages_.size() < kMaxSparePages) {
+        page->mesh.reset();
+        spare_pages_.push_back(std::move(*found));
+      }
+      pages_.Erase(page->page_x, page->page_y, page->page_z);
+      continue;
+    }
+
+    // Only up to the last range in use, since everything after it is free. The create info is kept between uploads so
+    // its buffers are reused
+    upload_info_.vertex_input_layout.assign(1, cl::ShaderDataType::kFloat2); // See chunk_vertex.hpp
+    upload_info_.vertices.assign(page->vertices.begin(), page->vertices.begin() + (size_t)page->vertex_ranges.GetUsedEnd() * ChunkVertex::kNumFloats);
+    upload_info_.indices.assign(page->indices.begin(), page->indices.begin() + page->index_ranges.GetUsedEnd());
+    page->mesh = context->CreateMesh(upload_info_);
+    ++page_uploads_;
+  }
+  dirty_pages_.clear();
+}
+
+void ChunkMeshPool::BuildCommands(const std::vector<Chunk*>& chunks, DrawCommandBuilder& builder) {
+  ++frame_;
+  builder.Clear();
+  batch_pages_.clear();
+
+  for (const Chunk* chunk : chunks) {
+    int page_x = PageOf(chunk->GetX()), page_y = PageOf(chunk->GetY()), page_z = PageOf(chunk->GetZ());
+    std::unique_ptr<Page>* found = pages_.Find(page_x, page_y, page_z);
+    if (!found || !(*found)->mesh) {
+      continue;
+    }
+    Page& page = **found;
+
+    const Allocation& allocation = page.allocations[SlotOf(chunk->GetX() - page_x * kPageSize,
+      chunk->GetY() - page_y * kPageSize, chunk->GetZ() - page_z * kPageSize)];
+    if (allocation.num_indices == 0) {
+      continue;
+    }
+
+    if (page.last_built_frame != frame_) {
+      page.last_built_frame = frame_;
+      page.batch = builder.AddBatch((uint32_t)batch_pages_.size());
+      batch_pages_.push_back(&page);
+    }
+    builder.AddRange(page.batch, allocation.index_offset, allocation.num_indices);
+  }
+
+  builder.Finish();
+}
+
+size_t ChunkMeshPool::Submit(const DrawCommandBuilder& builder, std::shared_ptr<cl::Shader>& shader) {
+  size_t draw_calls = 0;
+  vertices_submitted_ = 0;
+
+  const std::vector<DrawIndirectCommand>& commands = builder.GetCommands();
+  for (const DrawCommandBuilder::Batch& batch : builder.GetBatches()) {
+    if (batch.num_commands == 0) {
+      continue;
+    }
+    const Page& page = *batch_pages_[batch.key];
+
+    // Commands are sorted by first index, so each chunk's range is looked for in the last command starting at or
+    // before it
+    auto first = commands.begin() + batch.first_command;
+    auto last = first + batch.num_commands;
+    uint32_t visible[2] = { 0, 0 };
+    for (int slot = 0; slot < kPageSize * kPageSize * kPageSize; ++slot) {
+      const Allocation& allocation = page.allocations[slot];
+      if (allocation.num_indices == 0) {
+        continue;
+      }
+      auto command = std::upper_bound(first, last, allocation.index_offset, [](uint32_t offset, const DrawIndirectCommand& c){
+        return offset < c.first_index;
+      });
+      if (command != first && allocation.index_offset < (command - 1)->first_index + (command - 1)->index_count) {
+        visible[slot / 32] |= 1u << (slot % 32);
+      }
+    }
+
+    // Vertices are relative to the page origin, see chunk_vertex.hpp. w is the scale applied to them
+    const float kPageExtent = (float)(kPageSize * ChunkConstants::kChunkSize * scale_);
+    glm::vec4 origin(page.page_x * kPageExtent, page.page_y * kPageExtent, page.page_z * kPageExtent, (float)scale_);
+    shader->UploadUniform("u_page_origin", &origin);
+    shader->UploadUniform("u_page_visibility", visible);
+    page.mesh->Draw();
+    ++draw_calls;
+    vertices_submitted_ += page.vertex_ranges.GetUsedEnd();
+  }
+
+  return draw_calls;
+}
+
+ChunkMeshPool::Stats ChunkMeshPool::GetStats() const {
+  Stats stats;
+  stats.pages = pages_.Size();
+  stats.page_uploads = page_uploads_;
+  pages_.ForEach([&](const std::unique_ptr<Page>& page){
+    stats.vertices += (size_t)page->vertex_ranges.GetUsed();
+    stats.used_bytes += (size_t)page->vertex_ranges.GetUsed() * ChunkVertex::kNumFloats * sizeof(float)
+                      + (size_t)page->index_ranges.GetUsed() * sizeof(uint32_t);
+    stats.total_bytes += page->vertices.size() * sizeof(float) + page->indices.size() * sizeof(uint32_t);
+  });
+  return stats;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <calcium.hpp>
+
+#include "chunk_culler.hpp"
+#include "chunk_map.hpp"
+#include "chunk_mesher.hpp"
+#include "draw_command_builder.hpp"
+#include "range_allocator.hpp"
+
+class Chunk;
+
+// Holds chunk meshes in a small number of large shared buffers instead of one vertex and index buffer per chunk. The
+// world is split into pages of kPageSize^3 chunks, lined up with the culling groups, and every chunk mesh in a page
+// lives in that page's buffers at a range handed out by a RangeAllocator. Ranges freed by remeshing or unloading are
+// reused by later meshes. Each page is drawn with one draw call.
+//
+// calcium meshes can't be updated in place, so a changed page is uploaded again in full, at most once per frame. Nor
+// can they draw part of their index buffer, so the ranges in a batch's commands are drawn by passing the shader a mask
+// of the page's chunks they cover - every vertex in the page is still shaded, but chunks outside the mask are collapsed
+// to nothing before they reach the rasteriser. Store, Remove and BuildCommands only touch the CPU copy and need no
+// graphics context. A pool built with a scale above 1 holds ChunkLod node meshes, which the shader scales up by that
+// much
+class ChunkMeshPool {
+public:
+  static constexpr int kPageSize = ChunkCuller::kGroupSize;
+
+  ChunkMeshPool(int scale = 1) : scale_(scale) {}
+
+  struct Stats {
+    size_t pages        = 0;
+    size_t page_uploads = 0; // Since the last call to Upload
+    size_t vertices     = 0; // Held by chunk meshes
+    size_t used_bytes   = 0; // Held by chunk meshes
+    size_t total_bytes  = 0; // Including free ranges
+  };
+
+  // Copies mesh into the page holding the chunk, replacing any mesh the chunk had
+  void Store(int chunk_x, int chunk_y, int chunk_z, const ChunkMesh& mesh);
+  void Remove(int chunk_x, int chunk_y, int chunk_z);
+
+  // Uploads every page changed since the last call. Must be called on the thread that owns the context
+  void Upload(const std::shared_ptr<cl::Context>& context);
+
+  // Fills builder with one batch per page holding any of chunks, and one command per chunk mesh in that page. Pages
+  // must not be dropped between this and Submit, so call Upload first
+  void BuildCommands(const std::vector<Chunk*>& chunks, DrawCommandBuilder& builder);
+
+  // Draws the commands in builder, one draw call per batch, and returns the number of draw calls made. Only the chunks
+  // whose index ranges the commands cover produce any triangles
+  size_t Submit(const DrawCommandBuilder& builder, std::shared_ptr<cl::Shader>& shader);
+  // Shaded by the last call to Submit, including those of chunks masked out
+  inline size_t GetVerticesSubmitted() const { return vertices_submitted_; }
+
+  Stats GetStats() const;
+
+private:
+  struct Allocation {
+    uint32_t vertex_offset = 0;
+    uint32_t num_vertices  = 0;
+    uint32_t index_offset  = 0;
+    uint32_t num_indices   = 0;
+  };
+
+  struct Page {
+    int page_x = 0, page_y = 0, page_z = 0;
+
+    // CPU copy of the page's buffers. Vertices are counted in whole vertices by the allocator
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    RangeAllocator vertex_ranges;
+    RangeAllocator index_ranges;
+
+    Allocation allocations[kPageSize * kPageSize * kPageSize];
+    int num_meshes = 0;
+
+    bool dirty = false;
+    uint64_t last_built_frame = 0;
+    size_t batch = 0; // In the command builder, when last_built_frame is the current frame
+    std::shared_ptr<cl::Mesh> mesh;
+  };
+
+  static inline int PageOf(int chunk_coord) {
+    return chunk_coord >= 0 ? chunk_coord / kPageSize : (chunk_coord - kPageSize + 1) / kPageSize;
+  }
+
+  void FreeAllocation(Page& page, Allocation& allocation);
+
+private:
+  ChunkMap<std::unique_ptr<Page>> pages_;
+  std::vector<std::unique_ptr<Page>> spare_pages_;
+  cl::MeshCreateInfo upload_info_;
+  std::vector<Page*> dirty_pages_;
+  std::vector<Page*> batch_pages_; // Indexed by batch key
+  size_t page_uploads_ = 0;
+  size_t vertices_submitted_ = 0;
+  uint64_t frame_ = 0;
+  int scale_;
+};
@@ -0,0 +1,382 @@
+#include "chunk_mesher.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
+#include "chunk_constants.hpp"
+#include "chunk_light.hpp"
+#include "chunk_vertex.hpp"
+
+const size_t kVertexSize         = ChunkVertex::kNumFloats;
+const size_t kNumIndicesPerFace  = 6;
+
+const int kSize   = ChunkConstants::kChunkSize;
+const int kPadded = ChunkSnapshot::kPaddedSize;
+
+static_assert(kPadded <= 16, "A padded row of blocks must fit in a 16 bit mask");
+
+// How much each face direction is darkened, so faces read apart even in even light
+const float kShadeTop    = 0.8f;
+const float kShadeNorth  = 0.7f;
+const float kShadeSouth  = 0.6f;
+const float kShadeEast   = 0.5f;
+const float kShadeWest   = 0.4f;
+const float kShadeBottom = 0.3f;
+
+// Brightness of each light level, each a fifth dimmer than the one above, so light fades gently near its source and
+// caves fall dark
+struct LightCurve {
+  float brightness[ChunkLight::kMaxLight + 1];
+
+  LightCurve() {
+    float value = 1.0f;
+    for (int level = ChunkLight::kMaxLight; level >= 0; --level) {
+      brightness[level] = value;
+      value *= 0.8f;
+    }
+  }
+};
+
+static const LightCurve kLightCurve;
+
+// Brightness of a vertex by how many of the three blocks around it on the open side of the face are solid
+const float kAmbientOcclusion[4] = { 0.5f, 0.7f, 0.85f, 1.0f };
+
+const int kPaddedStrides[3] = { 1, ChunkSnapshot::kPaddedSize, ChunkSnapshot::kPaddedSize * ChunkSnapshot::kPaddedSize };
+
+struct MeshFace {
+  BlockFace face;
+  float shade;
+  int normal_axis;   // Axis along which the neighbouring block is checked
+  int normal_offset; // +1 or -1
+  int u_axis;        // Axis the texture u coordinate runs along
+  int v_axis;        // Axis the texture v coordinate runs along
+  int corners[4][5]; // x, y, z, u, v of each corner of a unit face: top left, top right, bottom left, bottom right
+};
+
+// Shared by both meshers so that they produce identical winding and texturing
+const MeshFace kFaces[] = {
+  { BlockFace::kSouth,  kShadeSouth,  2, +1, 0, 1, { { 0, 1, 1, 0, 1 }, { 1, 1, 1, 1, 1 }, { 0, 0, 1, 0, 0 }, { 1, 0, 1, 1, 0 } } },
+  { BlockFace::kNorth,  kShadeNorth,  2, -1, 0, 1, { { 1, 1, 0, 0, 1 }, { 0, 1, 0, 1, 1 }, { 1, 0, 0, 0, 0 }, { 0, 0, 0, 1, 0 } } },
+  { BlockFace::kWest,   kShadeWest,   0, +1, 2, 1, { { 1, 1, 1, 0, 1 }, { 1, 1, 0, 1, 1 }, { 1, 0, 1, 0, 0 }, { 1, 0, 0, 1, 0 } } },
+  { BlockFace::kEast,   kShadeEast,   0, -1, 2, 1, { { 0, 1, 0, 0, 1 }, { 0, 1, 1, 1, 1 }, { 0, 0, 0, 0, 0 }, { 0, 0, 1, 1, 0 } } },
+  { BlockFace::kBottom, kShadeBottom, 1, +1, 0, 2, { { 0, 1, 0, 0, 0 }, { 1, 1, 0, 1, 0 }, { 0, 1, 1, 0, 1 }, { 1, 1, 1, 1, 1 } } },
+  { BlockFace::kTop,    kShadeTop,    1, -1, 0, 2, { { 0, 0, 1, 0, 0 }, { 1, 0, 1, 1, 0 }, { 0, 0, 0, 0, 1 }, { 1, 0, 0, 1, 1 } } },
+};
+
+static inline int PopCount(uint32_t bits) {
+#ifdef _MSC_VER
+  return (int)__popcnt(bits);
+#else
+  return __builtin_popcount(bits);
+#endif
+}
+
+// bits must not be 0
+static inline int LowestBit(uint32_t bits) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, bits);
+  return (int)index;
+#else
+  return __builtin_ctz(bits);
+#endif
+}
+
+// The exposed faces of the chunk, one bit per block. rows[f][z][y] holds a bit for each x whose block has face f of
+// kFaces exposed, so the meshers visit only faces that are there rather than testing six neighbours per block
+struct FaceMasks {
+  uint16_t rows[6][kSize][kSize];
+  size_t num_faces;
+};
+
+static void BuildFaceMasks(const ChunkSnapshot& snapshot, FaceMasks& masks) {
+  // Solid blocks of the padded snapshot, with bit x + 1 for block x in each (y, z) row
+  uint16_t solid[kPadded][kPadded];
+  for (int z = 0; z < kPadded; ++z) {
+    for (int y = 0; y < kPadded; ++y) {
+      const Block* row = &snapshot.blocks[ChunkSnapshot::Index(-1, y - 1, z - 1)];
+      uint16_t bits = 0;
+      for (int x = 0; x < kPadded; ++x) {
+        bits |= (uint16_t)((BlockProps::IsSolid(row[x]) ? 1 : 0) << x);
+      }
+      solid[z][y] = bits;
+    }
+  }
+
+  // A face is exposed where a solid block meets one that isn't, found for a whole row at once by shifting or stepping
+  // to the neighbouring row and masking out the solid neighbours
+  masks.num_faces = 0;
+  for (int f = 0; f < 6; ++f) {
+    const MeshFace& face = kFaces[f];
+    for (int z = 0; z < kSize; ++z) {
+      for (int y = 0; y < kSize; ++y) {
+        uint32_t row = solid[z + 1][y + 1];
+        uint32_t neighbours;
+        switch (face.normal_axis) {
+          case 0:  neighbours = face.normal_offset > 0 ? row >> 1 : row << 1; break;
+          case 1:  neighbours = solid[z + 1][y + 1 + face.normal_offset]; break;
+          default: neighbours = solid[z + 1 + face.normal_offset][y + 1]; break;
+        }
+        uint16_t exposed = (uint16_t)(((row & ~neighbours) >> 1) & ((1u << kSize) - 1));
+        masks.rows[f][z][y] = exposed;
+        masks.num_faces += (size_t)PopCount(exposed);
+      }
+    }
+  }
+}
+
+static inline float CellBrightness(const ChunkSnapshot& snapshot, int index) {
+  uint8_t packed = snapshot.light[index];
+  int sky = ChunkLight::Sky(packed), block = ChunkLight::BlockLight(packed);
+  return kLightCurve.brightness[sky > block ? sky : block];
+}
+
+// Works out the light of each corner of the face of the block at pos. Each corner averages the light of the open
+// blocks touching it on the outside of the face, which smooths light across faces, and is darkened by the solid ones
+static void GetCornerLights(const ChunkSnapshot& snapshot, const MeshFace& face, const int* pos, int* lights) {
+  int outside = ChunkSnapshot::Index(pos[0], pos[1], pos[2]) + face.normal_offset * kPaddedStrides[face.normal_axis];
+  float outside_brightness = CellBrightness(snapshot, outside);
+
+  for (int c = 0; c < 4; ++c) {
+    int side1 = outside + (face.corners[c][face.u_axis] ? 1 : -1) * kPaddedStrides[face.u_axis];
+    int side2 = outside + (face.corners[c][face.v_axis] ? 1 : -1) * kPaddedStrides[face.v_axis];
+    int corner = side1 + side2 - outside;
+    bool solid1 = BlockProps::IsSolid(snapshot.blocks[side1]);
+    bool solid2 = BlockProps::IsSolid(snapshot.blocks[side2]);
+    // With both sides solid the corner block can't be seen from the face, so doesn't count
+    bool solid_corner = (solid1 && solid2) || BlockProps::IsSolid(snapshot.blocks[corner]);
+
+    float brightness = outside_brightness;
+    int num_open = 1;
+    if (!solid1) {
+      brightness += CellBrightness(snapshot, side1);
+      ++num_open;
+    }
+    if (!solid2) {
+      brightness += CellBrightness(snapshot, side2);
+      ++num_open;
+    }
+    if (!solid_corner) {
+      brightness += CellBrightness(snapshot, corner);
+      ++num_open;
+    }
+
+    int occlusion = solid1 && solid2 ? 0 : 3 - (int)solid1 - (int)solid2 - (int)solid_corner;
+    lights[c] = ChunkVertex::LightLevel(face.shade * kAmbientOcclusion[occlusion] * brightness / num_open);
+  }
+}
+
+// Writes a quad with the face's corners stretched over width by height blocks from base. UVs are scaled by the same
+// amount so the texture tiles once per block rather than stretching across the quad
+static void WriteQuad(const MeshFace& face, const int* base, int width, int height, int layer, const int* lights,
+                      float* vertices, size_t& current_vertex, uint32_t* indices, size_t& current_index,
+                      uint32_t& num_vertices) {
+  int extent[3] = { 1, 1, 1 };
+  extent[face.u_axis] = width;
+  extent[face.v_axis] = height;
+
+  for (int c = 0; c < 4; ++c) {
+    const int* corner = face.corners[c];
+    ChunkVertex::Write(&vertices[current_vertex],
+      base[0] + corner[0] * extent[0], base[1] + corner[1] * extent[1], base[2] + corner[2] * extent[2],
+      corner[3] * width, corner[4] * height, layer, lights[c]);
+    current_vertex += kVertexSize;
+  }
+
+  // Split along the diagonal between the brighter pair of corners, so light interpolates the same way whichever way
+  // round the quad is
+  if (lights[0] + lights[3] > lights[1] + lights[2]) {
+    indices[current_index++] = num_vertices + 0;
+    indices[current_index++] = num_vertices + 1;
+    indices[current_index++] = num_vertices + 3;
+    indices[current_index++] = num_vertices + 0;
+    indices[current_index++] = num_vertices + 3;
+    indices[current_index++] = num_vertices + 2;
+  } else {
+    indices[current_index++] = num_vertices + 0;
+    indices[current_index++] = num_vertices + 1;
+    indices[current_index++] = num_vertices + 2;
+    indices[current_index++] = num_vertices + 1;
+    indices[current_index++] = num_vertices + 3;
+    indices[current_index++] = num_vertices + 2;
+  }
+  num_vertices += 4;
+}
+
+static void BuildNaiveMesh(const ChunkSnapshot& snapshot, const FaceMasks& masks, ChunkMeshArena& arena) {
+  float* vertices = arena.vertices.data();
+  uint32_t* indices = arena.indices.data();
+
+  size_t current_vertex = 0;
+  size_t current_index = 0;
+  uint32_t num_vertices = 0;
+
+  for (int f = 0; f < 6; ++f) {
+    const MeshFace& face = kFaces[f];
+    for (int z = 0; z < kSize; ++z) {
+      for (int y = 0; y < kSize; ++y) {
+        for (uint32_t bits = masks.rows[f][z][y]; bits != 0; bits &= bits - 1) {
+          int pos[3] = { LowestBit(bits), y, z };
+          Block b = snapshot.GetBlockAt(pos[0], y, z);
+
+          int lights[4];
+          GetCornerLights(snapshot, face, pos, lights);
+          WriteQuad(face, pos, 1, 1, BlockProps::GetTextureIndex(b, face.face), lights,
+                    vertices, current_vertex, indices, current_index, num_vertices);
+        }
+      }
+    }
+  }
+
+  arena.num_vertex_floats = current_vertex;
+  arena.num_indices = current_index;
+}
+
+// Greedy mask entries hold the texture index + 1 in the low bits, 0 for no face, and the four corner lights above
+const int kMaskLightShift = 16;
+
+static inline uint64_t MaskKey(int texture, const int* lights) {
+  uint64_t key = (uint64_t)(texture + 1);
+  for (int c = 0; c < 4; ++c) {
+    key |= (uint64_t)lights[c] << (kMaskLightShift + c * 8);
+  }
+  return key;
+}
+
+static inline void MaskLights(uint64_t key, int* lights) {
+  for (int c = 0; c < 4; ++c) {
+    lights[c] = (int)((key >> (kMaskLightShift + c * 8)) & 0xff);
+  }
+}
+
+static void BuildGreedyMesh(const ChunkSnapshot& snapshot, const FaceMasks& masks, ChunkMeshArena& arena) {
+  // Merged quads never outnumber the faces the naive mesher would emit, so the arena is always large enough
+  float* vertices = arena.vertices.data();
+  uint32_t* indices = arena.indices.data();
+  size_t current_vertex = 0;
+  size_t current_index = 0;
+
+  uint64_t mask[kSize * kSize];
+  uint32_t num_vertices = 0;
+
+  for (int f = 0; f < 6; ++f) {
+    const MeshFace& face = kFaces[f];
+    for (int slice = 0; slice < kSize; ++slice) {
+      // Build the mask of exposed faces in this slice, indexed by (u, v) block coordinates
+      int pos[3];
+      pos[face.normal_axis] = slice;
+      for (int v = 0; v < kSize; ++v) {
+        pos[face.v_axis] = v;
+        for (int u = 0; u < kSize; ++u) {
+          pos[face.u_axis] = u;
+          uint64_t& entry = mask[u + v * kSize];
+          entry = 0;
+          if (((masks.rows[f][pos[2]][pos[1]] >> pos[0]) & 1) == 0) {
+            continue;
+          }
+
+          Block b = snapshot.GetBlockAt(pos[0], pos[1], pos[2]);
+          int lights[4];
+          GetCornerLights(snapshot, face, pos, lights);
+          entry = MaskKey(BlockProps::GetTextureIndex(b, face.face), lights);
+        }
+      }
+
+      // Grow rectangles out of the mask, first along u then along v, clearing faces as they are consumed
+      for (int v = 0; v < kSize; ++v) {
+        for (int u = 0; u < kSize;) {
+          uint64_t key = mask[u + v * kSize];
+          if (key == 0) {
+            ++u;
+            continue;
+          }
+
+          int lights[4];
+          MaskLights(key, lights);
+
+          // Neighbouring faces share the lights of the corners between them, so two side by side with the same key are
+          // lit evenly along the line joining them, and stretching one over both looks the same. A rectangle two or
+          // more faces each way is only found where the light is even at every corner
+          int width = 1;
+          while (u + width < kSize && mask[u + width + v * kSize] == key) {
+            ++width;
+          }
+
+          int height = 1;
+          for (; v + height < kSize; ++height) {
+            bool row_matches = true;
+            for (int i = 0; i < width; ++i) {
+              if (mask[u + i + (v + height) * kSize] != key) {
+                row_matches = false;
+                break;
+              }
+            }
+            if (!row_matches) {
+              break;
+            }
+          }
+
+          for (int j = 0; j < height; ++j) {
+            for (int i = 0; i < width; ++i) {
+              mask[u + i + (v + j) * kSize] = 0;
+            }
+          }
+
+          int base[3];
+          base[face.normal_axis] = slice;
+          base[face.u_axis] = u;
+          base[face.v_axis] = v;
+          WriteQuad(face, base, width, height, (int)(key & 0xffff) - 1, lights,
+                    vertices, current_vertex, indices, current_index, num_vertices);
+
+          u += width;
+        }
+      }
+    }
+  }
+
+  arena.num_vertex_floats = current_vertex;
+  arena.num_indices = current_index;
+}
+
+void ChunkMeshArena::CopyTo(ChunkMesh& mesh) const {
+  mesh.vertices.assign(vertices.begin(), vertices.begin() + num_vertex_floats);
+  mesh.indices.assign(indices.begin(), indices.begin() + num_indices);
+}
+
+namespace ChunkMesher {
+
+void BuildMesh(const ChunkSnapshot& snapshot, MeshingMode mode, ChunkMeshArena& arena) {
+  FaceMasks masks;
+  BuildFaceMasks(snapshot, masks);
+
+  // One quad per exposed face is exact for the naive mesher and an upper bound for the greedy one. The arena only
+  // grows, so it allocates just until it has held the largest mesh built
+  size_t vertex_floats = masks.num_faces * 4 * kVertexSize;
+  size_t num_indices = masks.num_faces * kNumIndicesPerFace;
+  if (arena.vertices.size() < vertex_floats) {
+    arena.vertices.resize(vertex_floats);
+  }
+  if (arena.indices.size() < num_indices) {
+    arena.indices.resize(num_indices);
+  }
+
+  switch (mode) {
+    case MeshingMode::kGreedy: BuildGreedyMesh(snapshot, masks, arena); break;
+    default:                   BuildNaiveMesh(snapshot, masks, arena);  break;
+  }
+}
+
+ChunkMesh CreateMesh(const ChunkSnapshot& snapshot, MeshingMode mode, ChunkMeshArena& arena) {
+  BuildMesh(snapshot, mode, arena);
+  ChunkMesh mesh;
+  arena.CopyTo(mesh);
+  return mesh;
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "block.hpp"
+#include "chunk_snapshot.hpp"
+
+enum class MeshingMode : char {
+  kNaive,  // One quad per exposed block face
+  kGreedy, // Coplanar neighbouring faces with matching texture and corner lights merged into larger quads
+};
+
+// A chunk's vertices and indices, sized exactly, with no ties to a graphics context. Vertices are in the packed
+// chunk-local format described in chunk_vertex.hpp
+struct ChunkMesh {
+  std::vector<float> vertices;
+  std::vector<uint32_t> indices;
+};
+
+// Scratch buffers the mesher writes into. The mesher counts a chunk's faces before building its mesh and grows them to
+// fit, so once they have held the largest mesh a thread builds, building a mesh allocates nothing. Keep one per
+// thread. Only the first num_vertex_floats and num_indices entries hold the last mesh built
+struct ChunkMeshArena {
+  std::vector<float> vertices;
+  std::vector<uint32_t> indices;
+  size_t num_vertex_floats = 0;
+  size_t num_indices = 0;
+
+  // Copies out the last mesh built, so the arena can be reused while the mesh is handed on. Reuses mesh's buffers if
+  // they are already large enough
+  void CopyTo(ChunkMesh& mesh) const;
+};
+
+namespace ChunkMesher {
+
+// Builds the mesh for the chunk at the centre of the snapshot into arena, culling faces hidden by neighbouring chunks.
+// Vertices are lit from the snapshot's light with smoothing and ambient occlusion.
+// Pure CPU work, safe to call from worker threads with a separate arena each
+void BuildMesh(const ChunkSnapshot& snapshot, MeshingMode mode, ChunkMeshArena& arena);
+
+// BuildMesh followed by ChunkMeshArena::CopyTo
+ChunkMesh CreateMesh(const ChunkSnapshot& snapshot, MeshingMode mode, ChunkMeshArena& arena);
+
+}
@@ -0,0 +1,70 @@
+#include "chunk_occlusion_culler.hpp"
+
+#include <algorithm>
+
+#include "chunk.hpp"
+#include "chunk_connectivity.hpp"
+
+// Chunk offset out through each face, in ChunkConnectivity's face order
+static const int kFaceOffsets[ChunkConnectivity::kNumFaces][3] = {
+  { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 }
+};
+
+void ChunkOcclusionCuller::Cull(int camera_x, int camera_y, int camera_z,
+                                const ChunkMap<std::unique_ptr<Chunk>>& chunks, std::vector<Chunk*>& visible) {
+  stats_ = Stats();
+  const std::unique_ptr<Chunk>* start = chunks.Find(camera_x, camera_y, camera_z);
+  if (!start) {
+    stats_.chunks_reached = visible.size();
+    return;
+  }
+
+  // Only chunks stamped with this search are entered, so the search stays inside the frustum
+  ++search_;
+  for (Chunk* chunk : visible) {
+    chunk->GetOcclusionState() = Chunk::OcclusionState { search_, 0, false };
+  }
+  // The camera's chunk can be just behind the near plane
+  (*start)->GetOcclusionState() = Chunk::OcclusionState { search_, 0, true };
+
+  queue_.Clear();
+  queue_.PushBack(Step { start->get(), -1, 0 });
+  while (!queue_.Empty()) {
+    Step step = queue_.Front();
+    queue_.PopFront();
+
+    const ChunkConnectivity& connectivity = step.chunk->GetConnectivity();
+    for (int face = 0; face < ChunkConnectivity::kNumFaces; ++face) {
+      if ((step.directions >> ChunkConnectivity::Opposite(face)) & 1) {
+        continue;
+      }
+      if (step.entry_face >= 0 && !connectivity.Connects(step.entry_face, face)) {
+        continue;
+      }
+
+      const int* offset = kFaceOffsets[face];
+      const std::unique_ptr<Chunk>* next = chunks.Find(step.chunk->GetX() + offset[0], step.chunk->GetY() + offset[1],
+                                                       step.chunk->GetZ() + offset[2]);
+      if (!next) {
+        continue;
+      }
+      Chunk::OcclusionState& state = (*next)->GetOcclusionState();
+      int entry_face = ChunkConnectivity::Opposite(face);
+      if (state.search != search_ || ((state.entered_faces >> entry_face) & 1)) {
+        continue;
+      }
+
+      // Paths only ever step one way along each axis, so a chunk is entered through at most three faces
+      state.entered_faces |= 1 << entry_face;
+      state.reached = true;
+      queue_.PushBack(Step { next->get(), entry_face, (uint8_t)(step.directions | (1 << face)) });
+    }
+  }
+
+  size_t num_visible = visible.size();
+  visible.erase(std::remove_if(visible.begin(), visible.end(), [](Chunk* chunk){
+    return !chunk->GetOcclusionState().reached;
+  }), visible.end());
+  stats_.chunks_reached = visible.size();
+  stats_.chunks_occluded = num_visible - visible.size();
+}
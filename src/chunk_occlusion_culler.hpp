@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chunk_map.hpp"
+#include "ring_queue.hpp"
+
+class Chunk;
+
+// Drops chunks that are in the frustum but walled off from the camera by solid terrain, such as caves below the
+// surface when the camera is above it, or the surface when the camera is in a cave. A breadth-first search spreads out
+// from the camera's chunk through the chunks already found in the frustum. A chunk entered through one face is only
+// left through the faces its ChunkConnectivity joins to that face, and never in the opposite direction to a step the
+// search took to reach it, so sight lines only move away from the camera. Every chunk the search reaches is kept, as
+// its near side may be seen even if nothing is seen through it.
+//
+// Connectivity is judged chunk by chunk, so a gap is taken to see through whatever lines up with it anywhere on the
+// far face. That keeps the test conservative apart from sight lines that would have to bend back on an axis.
+class ChunkOcclusionCuller {
+public:
+  struct Stats {
+    size_t chunks_reached  = 0;
+    size_t chunks_occluded = 0; // Passed in as visible but not reached
+  };
+
+  // visible holds the chunks found in the frustum, and has the ones the search doesn't reach removed. Nothing is
+  // removed if the camera's chunk isn't loaded, as there is then nowhere to start
+  void Cull(int camera_x, int camera_y, int camera_z, const ChunkMap<std::unique_ptr<Chunk>>& chunks,
+            std::vector<Chunk*>& visible);
+
+  inline const Stats& GetStats() const { return stats_; }
+
+private:
+  struct Step {
+    Chunk* chunk = nullptr;
+    int entry_face = -1; // Face of chunk the search came in through, -1 for the camera's chunk
+    uint8_t directions = 0; // Faces stepped out through on the way here, as a mask
+  };
+
+  RingQueue<Step> queue_;
+  uint32_t search_ = 0; // Numbers each search, for telling a chunk's scratch state from an earlier one's
+  Stats stats_;
+};
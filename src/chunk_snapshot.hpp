@@ -0,0 +1,73 @@
+#pragma once
+
+#include "block.hpp"
+#include "chunk_constants.hpp"
+#include "chunk_light.hpp"
+#include "chunk_storage.hpp"
+
+// Copy of a chunk's blocks and light surrounded by a one block border taken from its 26 neighbours, so the mesher and
+// lighter can see across chunk boundaries without touching the world. Border blocks of chunks that aren't loaded are
+// kUndefined.
+struct ChunkSnapshot {
+  static constexpr int kPaddedSize = ChunkConstants::kChunkSize + 2;
+
+  // Coordinates are chunk-local and may range from -1 to kChunkSize inclusive
+  static inline int Index(int x, int y, int z) { return (x + 1) + (y + 1) * kPaddedSize + (z + 1) * kPaddedSize * kPaddedSize; }
+  inline Block GetBlockAt(int x, int y, int z) const { return blocks[Index(x, y, z)]; }
+  inline void SetBlockAt(int x, int y, int z, Block b) { blocks[Index(x, y, z)] = b; }
+  // Packed as in ChunkLight
+  inline uint8_t GetLightAt(int x, int y, int z) const { return light[Index(x, y, z)]; }
+
+  // Fills the snapshot's blocks for the chunk at chunk_x, chunk_y, chunk_z. get_chunk(x, y, z) returns a pointer to
+  // the ChunkStorage of the chunk at those chunk coordinates, or nullptr if it isn't loaded
+  template <typename GetChunk>
+  void Fill(int chunk_x, int chunk_y, int chunk_z, GetChunk&& get_chunk) {
+    CopyPadded(chunk_x, chunk_y, chunk_z, get_chunk, [&](int x, int y, int z, const ChunkStorage* chunk, int source_index, int){
+      SetBlockAt(x, y, z, chunk ? chunk->Get(source_index) : Block::kUndefined);
+    });
+  }
+
+  // As Fill, for light. get_light(x, y, z) returns a pointer to a ChunkLight, or nullptr if the chunk isn't loaded or
+  // not yet lit. Those count as open sky if they are on the sky side of the chunk and dark otherwise
+  template <typename GetLight>
+  void FillLight(int chunk_x, int chunk_y, int chunk_z, GetLight&& get_light) {
+    CopyPadded(chunk_x, chunk_y, chunk_z, get_light, [&](int x, int y, int z, const ChunkLight* chunk, int source_index, int dy){
+      light[Index(x, y, z)] = chunk ? chunk->Get(source_index) : ChunkLight::Pack(dy < 0 ? ChunkLight::kMaxLight : 0, 0);
+    });
+  }
+
+  Block blocks[kPaddedSize * kPaddedSize * kPaddedSize];
+  uint8_t light[kPaddedSize * kPaddedSize * kPaddedSize];
+
+private:
+  // Padded coordinates -1 and kSize come from the neighbours on either side. For each of the 27 chunks in the 3x3x3
+  // block, works out which range of the padded snapshot it covers and where that range starts inside the chunk, then
+  // calls copy(x, y, z, source, source_index, dy) for every block in the range
+  template <typename GetSource, typename Copy>
+  void CopyPadded(int chunk_x, int chunk_y, int chunk_z, GetSource& get_source, Copy&& copy) {
+    const int kSize = ChunkConstants::kChunkSize;
+
+    for (int dz = -1; dz <= 1; ++dz) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          const int d[3] = { dx, dy, dz };
+          int begin[3], end[3], source[3];
+          for (int axis = 0; axis < 3; ++axis) {
+            begin[axis]  = d[axis] < 0 ? -1 : (d[axis] == 0 ? 0 : kSize);
+            end[axis]    = d[axis] < 0 ?  0 : (d[axis] == 0 ? kSize : kSize + 1);
+            source[axis] = d[axis] < 0 ? kSize - 1 : 0;
+          }
+
+          auto chunk = get_source(chunk_x + dx, chunk_y + dy, chunk_z + dz);
+          for (int z = begin[2]; z < end[2]; ++z) {
+            for (int y = begin[1]; y < end[1]; ++y) {
+              for (int x = begin[0]; x < end[0]; ++x) {
+                copy(x, y, z, chunk, ChunkStorage::Index(source[0] + x - begin[0], source[1] + y - begin[1], source[2] + z - begin[2]), dy);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};
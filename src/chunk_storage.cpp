@@ -0,0 +1,163 @@
+#include "chunk_storage.hpp"
+
+#include <algorithm>
+
+const int kNumBlockValues = 256;
+
+// Smallest index width that holds num_entries distinct values, restricted to widths that divide 64
+static int BitsForPaletteSize(int num_entries) {
+  if (num_entries <= 2) {
+    return 1;
+  }
+  return num_entries <= 4 ? 2 : 4;
+}
+
+ChunkStorage::ChunkStorage(Block uniform) : uniform_(uniform) {
+}
+
+ChunkStorage::ChunkStorage(const Block* blocks) {
+  Assign(blocks);
+}
+
+void ChunkStorage::Assign(const Block* blocks) {
+  uint16_t counts[kNumBlockValues] = { };
+  int distinct = 0;
+  for (int i = 0; i < kNumBlocks; ++i) {
+    if (counts[(uint8_t)blocks[i]]++ == 0) {
+      ++distinct;
+    }
+  }
+
+  words_.clear();
+  words_.shrink_to_fit();
+  dense_.clear();
+  dense_.shrink_to_fit();
+  dense_counts_.clear();
+  dense_counts_.shrink_to_fit();
+  palette_size_ = live_palette_entries_ = dense_distinct_ = 0;
+  bits_per_block_ = 0;
+
+  if (distinct == 1) {
+    mode_ = Mode::kUniform;
+    uniform_ = blocks[0];
+    return;
+  }
+
+  if (distinct <= kMaxPaletteSize) {
+    mode_ = Mode::kPalette;
+    bits_per_block_ = (uint8_t)BitsForPaletteSize(distinct);
+
+    // Palette order follows first appearance, which is as good as any
+    int palette_index[kNumBlockValues];
+    for (int i = 0; i < kNumBlocks; ++i) {
+      uint8_t value = (uint8_t)blocks[i];
+      if (counts[value] != 0) {
+        palette_index[value] = palette_size_;
+        palette_[palette_size_] = blocks[i];
+        palette_counts_[palette_size_] = counts[value];
+        ++palette_size_;
+        counts[value] = 0;
+      }
+    }
+    live_palette_entries_ = palette_size_;
+
+    words_.assign((kNumBlocks * bits_per_block_ + 63) / 64, 0);
+    for (int i = 0; i < kNumBlocks; ++i) {
+      WritePaletteIndex(i, palette_index[(uint8_t)blocks[i]]);
+    }
+    return;
+  }
+
+  mode_ = Mode::kDense;
+  dense_.assign(blocks, blocks + kNumBlocks);
+  dense_counts_.assign(counts, counts + kNumBlockValues);
+  dense_distinct_ = distinct;
+}
+
+void ChunkStorage::CopyTo(Block* blocks) const {
+  if (mode_ == Mode::kUniform) {
+    std::fill(blocks, blocks + kNumBlocks, uniform_);
+  }
+  else if (mode_ == Mode::kPalette) {
+    for (int i = 0; i < kNumBlocks; ++i) {
+      blocks[i] = palette_[ReadPaletteIndex(i)];
+    }
+  }
+  else {
+    std::copy(dense_.begin(), dense_.end(), blocks);
+  }
+}
+
+void ChunkStorage::Set(int index, Block b) {
+  Block old = Get(index);
+  if (old == b) {
+    return;
+  }
+
+  if (mode_ == Mode::kPalette) {
+    int old_entry = ReadPaletteIndex(index);
+    int new_entry = -1;
+    int free_entry = -1;
+    for (int i = 0; i < palette_size_; ++i) {
+      if (palette_counts_[i] != 0 && palette_[i] == b) {
+        new_entry = i;
+        break;
+      }
+      if (palette_counts_[i] == 0 && free_entry < 0) {
+        free_entry = i;
+      }
+    }
+
+    if (new_entry < 0) {
+      if (free_entry >= 0) {
+        new_entry = free_entry;
+      }
+      else if (palette_size_ < (1 << bits_per_block_)) {
+        new_entry = palette_size_++;
+      }
+      else {
+        // Needs wider indices, or the dense form
+        Repack(index, b);
+        return;
+      }
+      palette_[new_entry] = b;
+      ++live_palette_entries_;
+    }
+
+    WritePaletteIndex(index, new_entry);
+    ++palette_counts_[new_entry];
+    if (--palette_counts_[old_entry] == 0) {
+      --live_palette_entries_;
+      // Down to one block type, or few enough to use narrower indices
+      if (live_palette_entries_ == 1 || BitsForPaletteSize(live_palette_entries_) < bits_per_block_) {
+        Repack(index, b);
+      }
+    }
+    return;
+  }
+
+  if (mode_ == Mode::kDense) {
+    dense_[index] = b;
+    if (dense_counts_[(uint8_t)b]++ == 0) {
+      ++dense_distinct_;
+    }
+    if (--dense_counts_[(uint8_t)old] == 0 && --dense_distinct_ <= kMaxPaletteSize) {
+      Repack(index, b);
+    }
+    return;
+  }
+
+  Repack(index, b);
+}
+
+void ChunkStorage::Repack(int index, Block b) {
+  Block blocks[kNumBlocks];
+  CopyTo(blocks);
+  blocks[index] = b;
+  Assign(blocks);
+}
+
+size_t ChunkStorage::GetMemoryUsage() const {
+  return sizeof(*this) + words_.capacity() * sizeof(uint64_t) + dense_.capacity() * sizeof(Block)
+       + dense_counts_.capacity() * sizeof(uint16_t);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "block.hpp"
+#include "chunk_constants.hpp"
+#include "slab_allocator.hpp"
+
+// The blocks of one chunk, held in whichever of three forms is smallest:
+//   kUniform - every block is the same, so only that block is stored
+//   kPalette - up to kMaxPaletteSize distinct blocks, stored as 1, 2 or 4 bit indices into a palette
+//   kDense   - one byte per block
+// Writes move between forms as the number of distinct blocks grows and shrinks. Changing form repacks the whole
+// chunk, which is cheap next to remeshing it afterwards. The arrays behind each form come in a few fixed sizes, so
+// they are drawn from slab allocators and recycled as chunks stream in and out
+class ChunkStorage {
+public:
+  enum class Mode : char { kUniform, kPalette, kDense };
+
+  static constexpr int kNumBlocks = ChunkConstants::kChunkSize * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize;
+  static constexpr int kMaxPaletteSize = 16;
+
+  explicit ChunkStorage(Block uniform = Block::kAir);
+  // Copies kNumBlocks blocks in storage order
+  explicit ChunkStorage(const Block* blocks);
+
+  static inline int Index(int x, int y, int z) { return x + y * ChunkConstants::kChunkSize + z * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize; }
+
+  inline Block Get(int index) const {
+    if (mode_ == Mode::kUniform) {
+      return uniform_;
+    }
+    if (mode_ == Mode::kPalette) {
+      return palette_[ReadPaletteIndex(index)];
+    }
+    return dense_[index];
+  }
+  inline Block Get(int x, int y, int z) const { return Get(Index(x, y, z)); }
+
+  void Set(int index, Block b);
+  inline void Set(int x, int y, int z, Block b) { Set(Index(x, y, z), b); }
+
+  // Replaces every block with kNumBlocks blocks in storage order
+  void Assign(const Block* blocks);
+  // Writes out kNumBlocks blocks in storage order
+  void CopyTo(Block* blocks) const;
+
+  inline Mode GetMode() const { return mode_; }
+  inline int GetBitsPerBlock() const { return bits_per_block_; }
+  // Includes the storage object itself, for comparing against the kNumBlocks bytes of a plain array
+  size_t GetMemoryUsage() const;
+
+private:
+  inline int ReadPaletteIndex(int index) const {
+    // Index widths divide 64, so an index never straddles two words
+    int bit = index * bits_per_block_;
+    return (int)(words_[bit >> 6] >> (bit & 63)) & ((1 << bits_per_block_) - 1);
+  }
+
+  inline void WritePaletteIndex(int index, int palette_index) {
+    int bit = index * bits_per_block_;
+    uint64_t mask = (uint64_t)((1 << bits_per_block_) - 1) << (bit & 63);
+    words_[bit >> 6] = (words_[bit >> 6] & ~mask) | ((uint64_t)palette_index << (bit & 63));
+  }
+
+  // Writes b at index by unpacking, modifying and repacking the whole chunk, which picks the best form again
+  void Repack(int index, Block b);
+
+private:
+  Mode mode_ = Mode::kUniform;
+  uint8_t bits_per_block_ = 0;
+  Block uniform_ = Block::kAir;
+
+  // Palette form. Entries whose count falls to zero are reused before the palette grows
+  int palette_size_ = 0;
+  int live_palette_entries_ = 0;
+  Block palette_[kMaxPaletteSize] = { };
+  uint16_t palette_counts_[kMaxPaletteSize] = { };
+  SlabVector<uint64_t> words_;
+
+  // Dense form, with a count of each block value so it knows when it would fit in a palette again
+  int dense_distinct_ = 0;
+  SlabVector<Block> dense_;
+  SlabVector<uint16_t> dense_counts_;
+};
@@ -0,0 +1,146 @@
+#include "chunk_streamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "chunk_constants.hpp"
+#include "chunk_lod.hpp"
+#include "graphics_settings.hpp"
+
+const float kForwardBias = 0.5f;    // How strongly chunks in front of the camera are preferred. 0 = distance only
+const float kResortAngleCos = 0.9f; // Rebuild the load order once the camera turns further than about 25 degrees
+
+static inline int FloorDiv(float value) {
+  return (int)std::floor(value / ChunkConstants::kChunkSize);
+}
+
+static inline int NodeOf(int chunk_coord, int size) {
+  return chunk_coord >= 0 ? chunk_coord / size : (chunk_coord - size + 1) / size;
+}
+
+// Rings only nest inside one another from a view distance of 2, where a node's parent is always in the next ring out
+static inline int LodLevelsSetting() {
+  return GraphicsSettings::view_distance >= 2 ? std::clamp(GraphicsSettings::lod_levels, 0, ChunkLod::kMaxLevels) : 0;
+}
+
+ChunkStreamer::ChunkStreamer() {
+  BuildLoadOrder();
+}
+
+bool ChunkStreamer::SetCentre(const glm::vec3& eye, const glm::vec3& forward) {
+  int x = FloorDiv(eye.x), y = FloorDiv(eye.y), z = FloorDiv(eye.z);
+  bool moved = !has_centre_ || x != centre_x_ || y != centre_y_ || z != centre_z_;
+  has_centre_ = true;
+
+  bool settings_changed = view_distance_ != GraphicsSettings::view_distance
+                       || view_distance_vertical_ != GraphicsSettings::view_distance_vertical
+                       || lod_levels_ != LodLevelsSetting();
+  bool turned = glm::dot(forward, sorted_forward_) < kResortAngleCos;
+
+  if (turned || settings_changed) {
+    sorted_forward_ = forward;
+    BuildLoadOrder();
+  }
+  if (moved) {
+    centre_x_ = x;
+    centre_y_ = y;
+    centre_z_ = z;
+    cursor_ = 0;
+  }
+  if (moved || settings_changed) {
+    BuildLodLoadOrder();
+  }
+  return moved || settings_changed;
+}
+
+bool ChunkStreamer::ShouldLoad(int chunk_x, int chunk_y, int chunk_z) const {
+  return InLodRing(0, chunk_x, chunk_y, chunk_z);
+}
+
+bool ChunkStreamer::ShouldKeep(int chunk_x, int chunk_y, int chunk_z) const {
+  return InLodRing(0, chunk_x, chunk_y, chunk_z, GraphicsSettings::unload_margin);
+}
+
+bool ChunkStreamer::InLodRing(int level, int node_x, int node_y, int node_z, int margin) const {
+  if (level > lod_levels_) {
+    return false;
+  }
+
+  // The outer edge follows the nodes of the level above, except for the last ring which has none
+  bool outer = level == lod_levels_ ? IsNear(level, node_x, node_y, node_z, level, margin)
+                                    : IsNear(level + 1, NodeOf(node_x, 2), NodeOf(node_y, 2), NodeOf(node_z, 2), level, margin);
+  // Inside the inner edge the node is drawn at the level below
+  bool inner = level > 0 && IsNear(level, node_x, node_y, node_z, level - 1, -margin);
+  return outer && !inner;
+}
+
+// True if the centre of the node is within ring's view distance of the centre chunk, and the node overlaps the
+// vertical view distance
+bool ChunkStreamer::IsNear(int level, int node_x, int node_y, int node_z, int ring, int margin) const {
+  int size = ChunkLod::ScaleOf(level);
+  int radius = (view_distance_ + margin) * ChunkLod::ScaleOf(ring);
+  int vertical = view_distance_vertical_ + margin;
+  if (radius < 0) {
+    return false;
+  }
+
+  // Twice the offset between the centres, so that both are whole numbers of chunks
+  int dx = 2 * node_x * size + size - 2 * centre_x_ - 1;
+  int dz = 2 * node_z * size + size - 2 * centre_z_ - 1;
+  if (dx * dx + dz * dz > 4 * radius * radius) {
+    return false;
+  }
+  return node_y * size + size - 1 >= centre_y_ - vertical && node_y * size <= centre_y_ + vertical;
+}
+
+void ChunkStreamer::BuildLoadOrder() {
+  view_distance_ = GraphicsSettings::view_distance;
+  view_distance_vertical_ = GraphicsSettings::view_distance_vertical;
+  lod_levels_ = LodLevelsSetting();
+
+  // With LOD rings the full detail region is rounded out to whole level 1 nodes, which reach up to a chunk further.
+  // StreamIn skips the offsets that aren't loaded
+  int reach = view_distance_ + (lod_levels_ > 0 ? 1 : 0);
+  int reach_vertical = view_distance_vertical_ + (lod_levels_ > 0 ? 1 : 0);
+
+  load_order_.clear();
+  for (int x = -reach; x <= reach; ++x) {
+    for (int z = -reach; z <= reach; ++z) {
+      if (x * x + z * z > reach * reach) {
+        continue;
+      }
+      for (int y = -reach_vertical; y <= reach_vertical; ++y) {
+        float distance = std::sqrt((float)(x * x + y * y + z * z));
+        float along = distance > 0.0f ? glm::dot(glm::vec3((float)x, (float)y, (float)z) / distance, sorted_forward_) : 1.0f;
+        load_order_.push_back({ x, y, z, distance * (1.0f - kForwardBias * along) });
+      }
+    }
+  }
+
+  std::sort(load_order_.begin(), load_order_.end(), [](const Offset& a, const Offset& b){ return a.priority < b.priority; });
+  cursor_ = 0;
+}
+
+void ChunkStreamer::BuildLodLoadOrder() {
+  lod_load_order_.clear();
+  for (int level = 1; level <= lod_levels_; ++level) {
+    int size = ChunkLod::ScaleOf(level);
+    // Far enough to take in every node whose parent is in range
+    int reach = view_distance_ * size + 2 * size;
+
+    for (int x = NodeOf(centre_x_ - reach, size); x <= NodeOf(centre_x_ + reach, size); ++x) {
+      for (int z = NodeOf(centre_z_ - reach, size); z <= NodeOf(centre_z_ + reach, size); ++z) {
+        for (int y = NodeOf(centre_y_ - view_distance_vertical_, size); y <= NodeOf(centre_y_ + view_distance_vertical_, size); ++y) {
+          if (!InLodRing(level, x, y, z)) {
+            continue;
+          }
+          glm::vec3 offset((x + 0.5f) * size - (centre_x_ + 0.5f), (y + 0.5f) * size - (centre_y_ + 0.5f), (z + 0.5f) * size - (centre_z_ + 0.5f));
+          lod_load_order_.push_back({ level, x, y, z, glm::length(offset) });
+        }
+      }
+    }
+  }
+
+  std::sort(lod_load_order_.begin(), lod_load_order_.end(), [](const LodNode& a, const LodNode& b){ return a.priority < b.priority; });
+  lod_cursor_ = 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Decides which chunks should be resident around the camera. Chunks within the view distance are handed out for
+// loading nearest first, with chunks ahead of the camera preferred over those behind it. Loaded chunks are kept until
+// they fall outside the view distance plus a margin, so moving back and forth across a chunk border doesn't thrash.
+// Holds no chunk data itself and never touches the graphics context.
+//
+// Beyond the view distance the world is drawn in rings of ChunkLod nodes. Level 0 is full detail chunks, and each
+// level reaches twice as far as the one before with nodes twice the size. Every ring is made of whole nodes of the
+// level above it, so the levels fit together without gaps or overlaps. Where a ring meets a coarser or finer one the
+// mesher sees no neighbour and closes off the edge with faces, which covers the step in terrain height between them.
+class ChunkStreamer {
+public:
+  ChunkStreamer();
+
+  // Moves the centre of the streamed region to the chunk containing eye. Returns true if that is a different chunk
+  // than before, meaning chunks may now need unloading
+  bool SetCentre(const glm::vec3& eye, const glm::vec3& forward);
+
+  bool ShouldLoad(int chunk_x, int chunk_y, int chunk_z) const;
+  bool ShouldKeep(int chunk_x, int chunk_y, int chunk_z) const;
+
+  // True if the node of level at node_x, node_y, node_z is drawn at that level. With a margin, true if it is within
+  // margin nodes of being drawn, which is how long loaded nodes are kept
+  bool InLodRing(int level, int node_x, int node_y, int node_z, int margin = 0) const;
+  inline int GetLodLevels() const { return lod_levels_; }
+
+  // Walks the load order from where it last stopped, calling try_load(chunk_x, chunk_y, chunk_z) for each chunk in
+  // range. try_load returns true if it started loading the chunk, or false if it was already loaded or on its way.
+  // Stops once max_loads loads have been started
+  template <typename Fn>
+  void StreamIn(size_t max_loads, Fn&& try_load) {
+    size_t num_loads = 0;
+    while (cursor_ < load_order_.size() && num_loads < max_loads) {
+      const Offset& offset = load_order_[cursor_++];
+      int chunk_x = centre_x_ + offset.x, chunk_y = centre_y_ + offset.y, chunk_z = centre_z_ + offset.z;
+      if (ShouldLoad(chunk_x, chunk_y, chunk_z) && try_load(chunk_x, chunk_y, chunk_z)) {
+        ++num_loads;
+      }
+    }
+  }
+
+  // As StreamIn, for the nodes of every LOD ring above level 0, nearest first. Calls
+  // try_load(level, node_x, node_y, node_z)
+  template <typename Fn>
+  void StreamLodIn(size_t max_loads, Fn&& try_load) {
+    size_t num_loads = 0;
+    while (lod_cursor_ < lod_load_order_.size() && num_loads < max_loads) {
+      const LodNode& node = lod_load_order_[lod_cursor_++];
+      if (try_load(node.level, node.x, node.y, node.z)) {
+        ++num_loads;
+      }
+    }
+  }
+
+private:
+  struct Offset {
+    int x, y, z;
+    float priority;
+  };
+
+  struct LodNode {
+    int level;
+    int x, y, z;
+    float priority;
+  };
+
+  void BuildLoadOrder();
+  void BuildLodLoadOrder();
+  bool IsNear(int level, int node_x, int node_y, int node_z, int ring, int margin) const;
+
+private:
+  int centre_x_ = 0, centre_y_ = 0, centre_z_ = 0;
+  bool has_centre_ = false;
+
+  int view_distance_ = 0, view_distance_vertical_ = 0, lod_levels_ = 0;
+  glm::vec3 sorted_forward_ = glm::vec3(0.0f, 0.0f, -1.0f);
+
+  std::vector<Offset> load_order_;
+  size_t cursor_ = 0;
+
+  std::vector<LodNode> lod_load_order_; // In absolute node coordinates, rebuilt whenever the centre moves
+  size_t lod_cursor_ = 0;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Chunk mesh vertices are packed into two 32 bit floats, each holding an integer below 2^24 so that it survives the
+// trip through a float vertex attribute exactly. Positions are local to the chunk, whose origin is uploaded once per
+// draw. chunk_shader.vert.glsl decodes the same layout.
+//
+//   word 0: x (4 bits) | y (4 bits) | z (4 bits) | u (4 bits) | v (4 bits)
+//   word 1: texture layer (8 bits) | light (8 bits) | page x (2 bits) | page y (2 bits) | page z (2 bits)
+//
+// The page bits give the chunk's place within its ChunkMeshPool page. The mesher leaves them zero and the pool fills
+// them in when it copies a mesh into a page.
+namespace ChunkVertex {
+
+constexpr size_t kNumFloats = 2;
+
+constexpr int kMaxCoord = 15;   // Enough for positions and tiled UVs 0 to kChunkSize inclusive
+constexpr int kMaxLayer = 255;
+constexpr int kMaxLight = 255;
+constexpr int kMaxPageOffset = 3;
+
+struct Unpacked {
+  int x, y, z;
+  int u, v;
+  int layer;
+  int light;
+};
+
+constexpr uint32_t PackPosition(int x, int y, int z, int u, int v) {
+  return (uint32_t)x | ((uint32_t)y << 4) | ((uint32_t)z << 8) | ((uint32_t)u << 12) | ((uint32_t)v << 16);
+}
+
+constexpr uint32_t PackMaterial(int layer, int light) {
+  return (uint32_t)layer | ((uint32_t)light << 8);
+}
+
+constexpr uint32_t PackPageOffset(int x, int y, int z) {
+  return ((uint32_t)x << 16) | ((uint32_t)y << 18) | ((uint32_t)z << 20);
+}
+
+// Converts a light multiplier in the range 0-1 to the stored level
+constexpr int LightLevel(float light) {
+  return (int)(light * kMaxLight + 0.5f);
+}
+
+constexpr Unpacked Unpack(uint32_t position, uint32_t material) {
+  return Unpacked {
+    (int)(position & 0xf), (int)((position >> 4) & 0xf), (int)((position >> 8) & 0xf),
+    (int)((position >> 12) & 0xf), (int)((position >> 16) & 0xf),
+    (int)(material & 0xff), (int)((material >> 8) & 0xff),
+  };
+}
+
+// Writes one vertex to out, which must have room for kNumFloats floats
+inline void Write(float* out, int x, int y, int z, int u, int v, int layer, int light) {
+  out[0] = (float)PackPosition(x, y, z, u, v);
+  out[1] = (float)PackMaterial(layer, light);
+}
+
+constexpr bool RoundTrips(int x, int y, int z, int u, int v, int layer, int light) {
+  Unpacked unpacked = Unpack(PackPosition(x, y, z, u, v), PackMaterial(layer, light));
+  return unpacked.x == x && unpacked.y == y && unpacked.z == z && unpacked.u == u && unpacked.v == v
+      && unpacked.layer == layer && unpacked.light == light;
+}
+
+static_assert(RoundTrips(0, 0, 0, 0, 0, 0, 0), "Packed chunk vertex does not round trip");
+static_assert(RoundTrips(kMaxCoord, kMaxCoord, kMaxCoord, kMaxCoord, kMaxCoord, kMaxLayer, kMaxLight), "Packed chunk vertex does not round trip");
+static_assert(RoundTrips(12, 0, 7, 3, 12, 11, LightLevel(0.8f)), "Packed chunk vertex does not round trip");
+static_assert(PackPosition(kMaxCoord, kMaxCoord, kMaxCoord, kMaxCoord, kMaxCoord) < (1u << 24), "Packed chunk vertex words must be exactly representable as floats");
+static_assert((PackMaterial(kMaxLayer, kMaxLight) | PackPageOffset(kMaxPageOffset, kMaxPageOffset, kMaxPageOffset)) < (1u << 24), "Packed chunk vertex words must be exactly representable as floats");
+static_assert((PackMaterial(kMaxLayer, kMaxLight) & PackPageOffset(kMaxPageOffset, kMaxPageOffset, kMaxPageOffset)) == 0, "Packed chunk vertex fields overlap");
+
+}
@@ -0,0 +1,45 @@
+#include "draw_command_builder.hpp"
+
+#include <algorithm>
+
+void DrawCommandBuilder::Clear() {
+  ranges_.clear();
+  batches_.clear();
+  commands_.clear();
+}
+
+size_t DrawCommandBuilder::AddBatch(uint32_t key) {
+  batches_.push_back({ key, 0, 0 });
+  return batches_.size() - 1;
+}
+
+void DrawCommandBuilder::AddRange(size_t batch, uint32_t first_index, uint32_t index_count) {
+  if (index_count > 0) {
+    ranges_.push_back({ (uint32_t)batch, first_index, index_count });
+  }
+}
+
+void DrawCommandBuilder::Finish() {
+  std::sort(ranges_.begin(), ranges_.end(), [](const Range& a, const Range& b){
+    return a.batch != b.batch ? a.batch < b.batch : a.first_index < b.first_index;
+  });
+
+  commands_.clear();
+  for (size_t i = 0; i < ranges_.size();) {
+    const Range& first = ranges_[i];
+    Batch& batch = batches_[first.batch];
+    batch.first_command = commands_.size();
+
+    for (; i < ranges_.size() && ranges_[i].batch == first.batch; ++i) {
+      const Range& range = ranges_[i];
+      if (commands_.size() > batch.first_command
+       && commands_.back().first_index + commands_.back().index_count == range.first_index) {
+        commands_.back().index_count += range.index_count;
+      }
+      else {
+        commands_.push_back({ range.index_count, 1, range.first_index, 0, 0 });
+      }
+    }
+    batch.num_commands = commands_.size() - batch.first_command;
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Same layout as GL's DrawElementsIndirectCommand and Vulkan's VkDrawIndexedIndirectCommand, so the command array can
+// be copied into an indirect buffer as it is
+struct DrawIndirectCommand {
+  uint32_t index_count;
+  uint32_t instance_count;
+  uint32_t first_index;
+  int32_t  base_vertex;
+  uint32_t base_instance;
+};
+
+static_assert(sizeof(DrawIndirectCommand) == 20, "DrawIndirectCommand must match the graphics API layout");
+
+// Collects the index ranges to draw in a frame, grouped into batches that each draw from one set of buffers with one
+// multi-draw call. Within a batch ranges are sorted and ranges that touch are merged into a single command. Pure CPU
+// work with no graphics context involved
+class DrawCommandBuilder {
+public:
+  struct Batch {
+    uint32_t key;         // Whatever the caller uses to find the batch's buffers
+    size_t first_command; // Into GetCommands
+    size_t num_commands;
+  };
+
+  void Clear();
+
+  // Returns the index of the new batch, to pass to AddRange
+  size_t AddBatch(uint32_t key);
+  void AddRange(size_t batch, uint32_t first_index, uint32_t index_count);
+
+  // Sorts and merges the ranges added since Clear into commands. Call once after the last AddRange
+  void Finish();
+
+  inline const std::vector<Batch>& GetBatches() const { return batches_; }
+  inline const std::vector<DrawIndirectCommand>& GetCommands() const { return commands_; }
+
+private:
+  struct Range {
+    uint32_t batch;
+    uint32_t first_index;
+    uint32_t index_count;
+  };
+
+  std::vector<Range> ranges_;
+  std::vector<Batch> batches_;
+  std::vector<DrawIndirectCommand> commands_;
+};
@@ -0,0 +1,93 @@
+#include "frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #define CALCIUM_FRUSTUM_SSE 1
+  #include <xmmintrin.h>
+#endif
+
+Frustum Frustum::FromViewProjection(const glm::mat4& vp) {
+  // glm is column major, so row i of the matrix is (vp[0][i], vp[1][i], vp[2][i], vp[3][i])
+  auto row = [&](int i){ return glm::vec4(vp[0][i], vp[1][i], vp[2][i], vp[3][i]); };
+  glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+  Frustum frustum;
+  frustum.planes[0] = r3 + r0; // left
+  frustum.planes[1] = r3 - r0; // right
+  frustum.planes[2] = r3 + r1; // bottom
+  frustum.planes[3] = r3 - r1; // top
+  frustum.planes[4] = r3 + r2; // near
+  frustum.planes[5] = r3 - r2; // far
+
+  for (auto& plane : frustum.planes) {
+    float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+    if (length > 0.0f) {
+      plane = plane / length;
+    }
+  }
+  return frustum;
+}
+
+Containment Frustum::ClassifyBox(const glm::vec3& min, const glm::vec3& max) const {
+  Containment result = Containment::kInside;
+  for (const auto& plane : planes) {
+    // Corner furthest along the plane normal, and the one furthest against it
+    glm::vec3 positive(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z);
+    glm::vec3 negative(plane.x >= 0.0f ? min.x : max.x, plane.y >= 0.0f ? min.y : max.y, plane.z >= 0.0f ? min.z : max.z);
+
+    if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f) {
+      return Containment::kOutside;
+    }
+    if (plane.x * negative.x + plane.y * negative.y + plane.z * negative.z + plane.w < 0.0f) {
+      result = Containment::kIntersecting;
+    }
+  }
+  return result;
+}
+
+void Frustum::CullCubes(const float* xs, const float* ys, const float* zs, size_t count, float size, uint8_t* visible) const {
+  // For a cube the corner furthest along each plane normal is the minimum corner plus a fixed offset, so it folds into
+  // the plane distance and each plane costs one dot product per cube
+  float offsets[6];
+  for (int p = 0; p < 6; ++p) {
+    offsets[p] = planes[p].w + size * (std::max(planes[p].x, 0.0f) + std::max(planes[p].y, 0.0f) + std::max(planes[p].z, 0.0f));
+  }
+
+  size_t i = 0;
+
+#ifdef CALCIUM_FRUSTUM_SSE
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_loadu_ps(xs + i);
+    __m128 y = _mm_loadu_ps(ys + i);
+    __m128 z = _mm_loadu_ps(zs + i);
+
+    __m128 inside = _mm_cmpeq_ps(zero, zero);
+    for (int p = 0; p < 6; ++p) {
+      __m128 distance = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes[p].x)), _mm_mul_ps(y, _mm_set1_ps(planes[p].y))),
+        _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(planes[p].z)), _mm_set1_ps(offsets[p])));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+    }
+
+    int mask = _mm_movemask_ps(inside);
+    visible[i + 0] = (mask >> 0) & 1;
+    visible[i + 1] = (mask >> 1) & 1;
+    visible[i + 2] = (mask >> 2) & 1;
+    visible[i + 3] = (mask >> 3) & 1;
+  }
+#endif
+
+  for (; i < count; ++i) {
+    uint8_t inside = 1;
+    for (int p = 0; p < 6; ++p) {
+      if (planes[p].x * xs[i] + planes[p].y * ys[i] + planes[p].z * zs[i] + offsets[p] < 0.0f) {
+        inside = 0;
+        break;
+      }
+    }
+    visible[i] = inside;
+  }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+enum class Containment : char {
+  kOutside, kIntersecting, kInside
+};
+
+// View frustum as six inward facing planes, for culling on the CPU
+struct Frustum {
+  // Extracts the planes from a combined view-projection matrix (Gribb/Hartmann)
+  static Frustum FromViewProjection(const glm::mat4& vp);
+
+  Containment ClassifyBox(const glm::vec3& min, const glm::vec3& max) const;
+
+  // Tests count axis aligned cubes with edge length size, whose minimum corners are given as separate x, y and z
+  // arrays, setting visible[i] to 1 for each cube at least partly inside and 0 otherwise. Where SSE is available four
+  // cubes are tested per iteration
+  void CullCubes(const float* xs, const float* ys, const float* zs, size_t count, float size, uint8_t* visible) const;
+
+  glm::vec4 planes[6]; // xyz = normal pointing into the frustum, w = distance
+};
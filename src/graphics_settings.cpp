@@ -0,0 +1,21 @@
+#include "graphics_settings.hpp"
+
+namespace GraphicsSettings {
+
+MeshingMode meshing_mode = MeshingMode::kGreedy;
+
+int view_distance               = 12;
+int view_distance_vertical      = 3;
+int unload_margin               = 2;
+int max_chunk_loads_per_frame   = 32;
+int max_chunk_unloads_per_frame = 32;
+int max_remeshes_per_frame      = 64;
+int max_relights_per_frame      = 64;
+int lod_levels                  = 3;
+int max_lod_builds_in_flight    = 4;
+
+bool frustum_culling      = true;
+bool hierarchical_culling = true;
+bool occlusion_culling    = true;
+
+}
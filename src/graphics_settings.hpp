@@ -0,0 +1,23 @@
+#pragma once
+
+#include "chunk_mesher.hpp"
+
+namespace GraphicsSettings {
+
+extern MeshingMode meshing_mode;
+
+extern int view_distance;             // horizontal radius, in chunks
+extern int view_distance_vertical;    // chunks above and below the camera
+extern int unload_margin;             // extra chunks kept beyond the view distance before unloading
+extern int max_chunk_loads_per_frame;
+extern int max_chunk_unloads_per_frame;
+extern int max_remeshes_per_frame;    // chunks changed by block edits or relighting sent to the workers each frame
+extern int max_relights_per_frame;    // chunks whose light needs recomputing sent to the workers each frame
+extern int lod_levels;                // rings of coarser chunks beyond the view distance, each reaching twice as far, up to 3
+extern int max_lod_builds_in_flight;  // LOD nodes being built on the workers at once
+
+extern bool frustum_culling;
+extern bool hierarchical_culling; // test groups of chunks before individual chunks
+extern bool occlusion_culling;    // skip full detail chunks walled off from the camera by solid terrain
+
+}
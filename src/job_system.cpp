@@ -0,0 +1,74 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+
+#include "profiler.hpp"
+
+JobSystem::JobSystem(size_t num_threads) : jobs_(kQueueCapacity) {
+  if (num_threads == 0) {
+    unsigned int hardware_threads = std::thread::hardware_concurrency();
+    num_threads = std::max(1u, hardware_threads > 1 ? hardware_threads - 1 : 1u);
+  }
+
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this](){ WorkerLoop(); });
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    running_.store(false, std::memory_order_release);
+  }
+  wake_workers_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void JobSystem::Schedule(Job job) {
+  pending_jobs_.fetch_add(1, std::memory_order_acq_rel);
+  queued_jobs_.fetch_add(1, std::memory_order_acq_rel);
+
+  // Only spins if a caller has more than kQueueCapacity jobs outstanding
+  while (!jobs_.TryPush(std::move(job))) {
+    std::this_thread::yield();
+  }
+
+  // Taking the lock here means a worker can't miss the notification between checking the queue and going to sleep
+  { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+  wake_workers_.notify_one();
+}
+
+void JobSystem::WaitIdle() {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  wake_waiters_.wait(lock, [this](){ return pending_jobs_.load(std::memory_order_acquire) == 0; });
+}
+
+void JobSystem::WorkerLoop() {
+  PROFILE_THREAD("Worker");
+
+  Job job;
+  while (true) {
+    if (jobs_.TryPop(job)) {
+      queued_jobs_.fetch_sub(1, std::memory_order_acq_rel);
+      job();
+      job = nullptr;
+
+      if (pending_jobs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        wake_waiters_.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    if (!running_.load(std::memory_order_acquire)) {
+      return;
+    }
+    wake_workers_.wait(lock, [this](){
+      return !running_.load(std::memory_order_acquire) || queued_jobs_.load(std::memory_order_acquire) > 0;
+    });
+  }
+}
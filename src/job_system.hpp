@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+
+// Fixed pool of worker threads pulling jobs from a shared lock-free queue. Jobs must not touch the graphics context -
+// they are for CPU work such as chunk generation and meshing, with results handed back to the main thread.
+class JobSystem {
+public:
+  // A job's callable, held in place rather than on the heap as std::function does for all but the smallest captures,
+  // so that scheduling a job never allocates. Captures must fit in kCaptureSize bytes. Move only
+  class Job {
+  public:
+    static constexpr size_t kCaptureSize = 64;
+
+    Job() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Job>>>
+    Job(F&& fn) {
+      using Fn = std::decay_t<F>;
+      static_assert(sizeof(Fn) <= kCaptureSize, "Job captures too much to be held in place");
+      static_assert(alignof(Fn) <= alignof(std::max_align_t), "Job captures are over-aligned");
+      new (storage_) Fn(std::forward<F>(fn));
+      invoke_ = [](void* storage){ (*static_cast<Fn*>(storage))(); };
+      relocate_ = [](void* from, void* to){
+        if (to) {
+          new (to) Fn(std::move(*static_cast<Fn*>(from)));
+        }
+        static_cast<Fn*>(from)->~Fn();
+      };
+    }
+
+    Job(Job&& other) noexcept { Take(other); }
+    Job& operator=(Job&& other) noexcept {
+      if (this != &other) {
+        Reset();
+        Take(other);
+      }
+      return *this;
+    }
+    Job& operator=(std::nullptr_t) noexcept { Reset(); return *this; }
+    ~Job() { Reset(); }
+
+    inline void operator()() { invoke_(storage_); }
+
+  private:
+    void Reset() {
+      if (relocate_) {
+        relocate_(storage_, nullptr);
+        invoke_ = nullptr;
+        relocate_ = nullptr;
+      }
+    }
+
+    void Take(Job& other) {
+      if (other.relocate_) {
+        other.relocate_(other.storage_, storage_);
+        invoke_ = other.invoke_;
+        relocate_ = other.relocate_;
+        other.invoke_ = nullptr;
+        other.relocate_ = nullptr;
+      }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[kCaptureSize];
+    void (*invoke_)(void* storage) = nullptr;
+    void (*relocate_)(void* from, void* to) = nullptr; // Moves the callable to to, or just destroys it if to is null
+  };
+
+  // Jobs that can be waiting for a worker at once
+  static constexpr size_t kQueueCapacity = 4096;
+
+  // A thread count of 0 uses one worker per hardware thread, minus one for the main thread
+  explicit JobSystem(size_t num_threads = 0);
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  // Callers are expected to keep no more than kQueueCapacity jobs outstanding. Past that this waits on the main thread
+  // for the workers to make room
+  void Schedule(Job job);
+
+  // Blocks until every job scheduled so far has finished
+  void WaitIdle();
+
+  inline size_t GetThreadCount() const { return workers_.size(); }
+  inline size_t GetPendingJobCount() const { return pending_jobs_.load(std::memory_order_acquire); }
+
+private:
+  void WorkerLoop();
+
+private:
+  MpmcQueue<Job> jobs_;
+  std::vector<std::thread> workers_;
+
+  std::atomic<size_t> pending_jobs_ = 0; // scheduled but not yet finished
+  std::atomic<size_t> queued_jobs_ = 0;  // scheduled but not yet picked up by a worker
+  std::atomic<bool> running_ = true;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_workers_;
+  std::condition_variable wake_waiters_;
+};
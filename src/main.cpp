@@ -1,11 +1,20 @@
 #include <chrono>
+#include <cstdio>
 
 #include <calcium.hpp>
 
 #include "key_bindings.hpp"
+#include "profiler.hpp"
+#include "slab_allocator.hpp"
 #include "world.hpp"
 
+#ifdef CALCIUM_BUILD_PROFILE
+const auto kFrameStatsInterval = std::chrono::seconds(5);
+const char* kTracePath = "profile.json";
+#endif
+
 int main() {
+  PROFILE_THREAD("Main");
   auto context = cl::Context::CreateContext(cl::Backend::kOpenGL);
 
   cl::WindowCreateInfo window_info;
@@ -42,20 +51,50 @@ int main() {
 
   World world(context);
 
-  auto start_time = std::chrono::high_resolution_clock::now();
+#ifdef CALCIUM_BUILD_PROFILE
+  auto frame_start = std::chrono::steady_clock::now();
+  auto last_report = frame_start;
+#endif
 
   chunk_shader->BindTextureArray("u_block_texture_array", block_texture_array);
   while (window->IsOpen()) {
+    PROFILE_SCOPE("Frame");
     window->PollEvents();
 
     camera->FreeControl(window);
     camera->UploadTo(chunk_shader);
 
+    world.Update(camera);
+
     context->BeginFrame();
 
     chunk_shader->Bind();
-    world.Render(camera);
+    world.Render(camera, chunk_shader);
 
     context->EndFrame();
+
+#ifdef CALCIUM_BUILD_PROFILE
+    auto frame_end = std::chrono::steady_clock::now();
+    const World::RenderStats& stats = world.GetRenderStats();
+    Profiler::EndFrame(std::chrono::duration<float, std::milli>(frame_end - frame_start).count(), stats.chunks_loaded, stats.vertices_resident);
+    frame_start = frame_end;
+
+    if (frame_end - last_report >= kFrameStatsInterval) {
+      Profiler::FrameStats frame_stats = Profiler::GetFrameStats();
+      std::printf("frame ms p50 %.2f p95 %.2f p99 %.2f max %.2f | chunks %zu | vertices %zu\n", frame_stats.p50_ms,
+        frame_stats.p95_ms, frame_stats.p99_ms, frame_stats.max_ms, frame_stats.chunks_loaded, frame_stats.vertices_resident);
+      for (const SlabAllocator::Stats& slab : SlabAllocator::GetAllStats()) {
+        std::printf("  slab %5zu B | live %zu | high water %zu | capacity %zu | reused %.1f%% of %llu\n", slab.block_size,
+          slab.live, slab.high_water, slab.capacity, slab.GetReuseRate() * 100.0f, (unsigned long long)slab.allocations);
+      }
+      last_report = frame_end;
+    }
+#endif
+  }
+
+#ifdef CALCIUM_BUILD_PROFILE
+  if (Profiler::WriteChromeTrace(kTracePath)) {
+    std::printf("Wrote trace to %s\n", kTracePath);
   }
+#endif
 }
@@ -0,0 +1,164 @@
+#include "profiler.hpp"
+
+#ifdef CALCIUM_BUILD_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Profiler {
+
+static_assert((kEventsPerThread & (kEventsPerThread - 1)) == 0, "Events per thread must be a power of two");
+
+const size_t kFrameHistory = 8192; // Frames kept for the trace, of which the last kFrameWindow give the percentiles
+
+struct Event {
+  const char* name;
+  uint64_t start_ns;
+  uint64_t end_ns;
+};
+
+// Written only by its own thread. head counts every event ever recorded, so the buffer holds the last
+// kEventsPerThread of them
+struct ThreadBuffer {
+  uint32_t thread_id = 0;
+  const char* name = nullptr;
+  std::atomic<uint64_t> head = 0;
+  Event events[kEventsPerThread];
+};
+
+struct FrameSample {
+  uint64_t end_ns;
+  float frame_ms;
+  size_t chunks_loaded;
+  size_t vertices_resident;
+};
+
+static const auto kStartTime = std::chrono::steady_clock::now();
+
+// Buffers are never freed, so a trace can still be written after the threads that filled them have exited
+static std::mutex buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+static FrameSample frames[kFrameHistory];
+static uint64_t num_frames = 0;
+
+static ThreadBuffer& GetThreadBuffer() {
+  thread_local ThreadBuffer* buffer = nullptr;
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    buffers.push_back(std::make_unique<ThreadBuffer>());
+    buffer = buffers.back().get();
+    buffer->thread_id = (uint32_t)buffers.size();
+  }
+  return *buffer;
+}
+
+uint64_t Now() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kStartTime).count();
+}
+
+void Record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+  ThreadBuffer& buffer = GetThreadBuffer();
+  uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  buffer.events[head & (kEventsPerThread - 1)] = Event { name, start_ns, end_ns };
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void SetThreadName(const char* name) {
+  GetThreadBuffer().name = name;
+}
+
+void EndFrame(float frame_ms, size_t chunks_loaded, size_t vertices_resident) {
+  frames[num_frames % kFrameHistory] = FrameSample { Now(), frame_ms, chunks_loaded, vertices_resident };
+  ++num_frames;
+}
+
+FrameStats GetFrameStats() {
+  FrameStats stats;
+  stats.frames = (size_t)std::min<uint64_t>(num_frames, kFrameWindow);
+  if (stats.frames == 0) {
+    return stats;
+  }
+
+  float times[kFrameWindow];
+  for (size_t i = 0; i < stats.frames; ++i) {
+    times[i] = frames[(num_frames - 1 - i) % kFrameHistory].frame_ms;
+  }
+  auto percentile = [&](float p){
+    size_t rank = std::min(stats.frames - 1, (size_t)(p * stats.frames));
+    std::nth_element(times, times + rank, times + stats.frames);
+    return times[rank];
+  };
+  stats.p50_ms = percentile(0.50f);
+  stats.p95_ms = percentile(0.95f);
+  stats.p99_ms = percentile(0.99f);
+  stats.max_ms = *std::max_element(times, times + stats.frames);
+
+  const FrameSample& last = frames[(num_frames - 1) % kFrameHistory];
+  stats.chunks_loaded = last.chunks_loaded;
+  stats.vertices_resident = last.vertices_resident;
+  return stats;
+}
+
+bool WriteChromeTrace(const std::string& path) {
+  FILE* file = std::fopen(path.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool first = true;
+  auto separator = [&](){
+    const char* s = first ? "" : ",\n";
+    first = false;
+    return s;
+  };
+
+  std::vector<Event> events;
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  for (const auto& buffer : buffers) {
+    if (buffer->name) {
+      std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+        separator(), buffer->thread_id, buffer->name);
+    }
+
+    // The owning thread may overwrite the oldest events while they are copied, so any that could have been are
+    // dropped once the copy is done
+    uint64_t end = buffer->head.load(std::memory_order_acquire);
+    uint64_t begin = end > kEventsPerThread ? end - kEventsPerThread : 0;
+    events.clear();
+    for (uint64_t i = begin; i < end; ++i) {
+      events.push_back(buffer->events[i & (kEventsPerThread - 1)]);
+    }
+    uint64_t head_after = buffer->head.load(std::memory_order_acquire);
+    uint64_t first_intact = head_after > kEventsPerThread ? head_after - kEventsPerThread : 0;
+    size_t skip = (size_t)(std::max(first_intact, begin) - begin);
+
+    for (size_t i = skip; i < events.size(); ++i) {
+      const Event& event = events[i];
+      std::fprintf(file, "%s{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+        separator(), event.name, buffer->thread_id, event.start_ns / 1000.0, (event.end_ns - event.start_ns) / 1000.0);
+    }
+  }
+
+  uint64_t first_frame = num_frames > kFrameHistory ? num_frames - kFrameHistory : 0;
+  for (uint64_t i = first_frame; i < num_frames; ++i) {
+    const FrameSample& frame = frames[i % kFrameHistory];
+    std::fprintf(file, "%s{\"ph\":\"C\",\"name\":\"frame_ms\",\"pid\":1,\"ts\":%.3f,\"args\":{\"frame_ms\":%.3f}}",
+      separator(), frame.end_ns / 1000.0, frame.frame_ms);
+    std::fprintf(file, "%s{\"ph\":\"C\",\"name\":\"world\",\"pid\":1,\"ts\":%.3f,\"args\":{\"chunks_loaded\":%zu,\"vertices_resident\":%zu}}",
+      separator(), frame.end_ns / 1000.0, frame.chunks_loaded, frame.vertices_resident);
+  }
+
+  std::fprintf(file, "\n]}\n");
+  return std::fclose(file) == 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped timing of the hot paths, compiled in only for Profile builds (CALCIUM_BUILD_PROFILE) so other builds pay
+// nothing. Each thread records into its own ring buffer of the most recent events, so recording takes no locks and
+// never allocates. The buffers can be written out as a Chrome trace (chrome://tracing or ui.perfetto.dev) to find
+// what a spike was spent on.
+//
+// The main thread also reports each frame, and rolling frame time percentiles over the last kFrameWindow frames are
+// kept alongside the world's loaded chunk and resident vertex counts.
+#ifdef CALCIUM_BUILD_PROFILE
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// name must be a string literal, or otherwise live for the rest of the program
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+
+#endif
+
+#ifdef CALCIUM_BUILD_PROFILE
+
+namespace Profiler {
+
+constexpr size_t kEventsPerThread = 1 << 16;
+constexpr size_t kFrameWindow = 1024;
+
+uint64_t Now(); // Nanoseconds since the profiler started
+
+// Records a span on the calling thread's ring buffer, overwriting its oldest event once the buffer is full
+void Record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+// Names the calling thread in traces. name must live for the rest of the program
+void SetThreadName(const char* name);
+
+class Scope {
+public:
+  explicit Scope(const char* name) : name_(name), start_ns_(Now()) {}
+  ~Scope() { Record(name_, start_ns_, Now()); }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* name_;
+  uint64_t start_ns_;
+};
+
+struct FrameStats {
+  size_t frames = 0; // In the window, up to kFrameWindow
+  float p50_ms = 0.0f;
+  float p95_ms = 0.0f;
+  float p99_ms = 0.0f;
+  float max_ms = 0.0f;
+  size_t chunks_loaded = 0;
+  size_t vertices_resident = 0;
+};
+
+// Called by the main thread once per frame with the time it took and the world's counters at its end
+void EndFrame(float frame_ms, size_t chunks_loaded, size_t vertices_resident);
+
+// Percentiles of the frames in the window, and the counters from the last frame. Main thread only
+FrameStats GetFrameStats();
+
+// Writes every thread's buffered events, and the frame counters, to path as Chrome trace JSON. Threads may keep
+// recording while it runs - events overwritten during the copy are dropped. Returns false if the file can't be written
+bool WriteChromeTrace(const std::string& path);
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "range_allocator.hpp"
+
+#include <algorithm>
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : capacity_(capacity) {
+  if (capacity > 0) {
+    free_ranges_.push_back({ 0, capacity });
+  }
+}
+
+uint32_t RangeAllocator::Allocate(uint32_t size) {
+  if (size == 0) {
+    return kInvalidOffset;
+  }
+
+  for (size_t i = 0; i < free_ranges_.size(); ++i) {
+    Range& range = free_ranges_[i];
+    if (range.size < size) {
+      continue;
+    }
+
+    uint32_t offset = range.offset;
+    range.offset += size;
+    range.size -= size;
+    if (range.size == 0) {
+      free_ranges_.erase(free_ranges_.begin() + i);
+    }
+    used_ += size;
+    return offset;
+  }
+
+  return kInvalidOffset;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t size) {
+  if (size == 0) {
+    return;
+  }
+  used_ -= size;
+
+  auto next = std::lower_bound(free_ranges_.begin(), free_ranges_.end(), offset,
+    [](const Range& range, uint32_t value){ return range.offset < value; });
+
+  bool joins_previous = next != free_ranges_.begin() && (next - 1)->offset + (next - 1)->size == offset;
+  bool joins_next = next != free_ranges_.end() && offset + size == next->offset;
+
+  if (joins_previous && joins_next) {
+    (next - 1)->size += size + next->size;
+    free_ranges_.erase(next);
+  }
+  else if (joins_previous) {
+    (next - 1)->size += size;
+  }
+  else if (joins_next) {
+    next->offset = offset;
+    next->size += size;
+  }
+  else {
+    free_ranges_.insert(next, { offset, size });
+  }
+}
+
+void RangeAllocator::Grow(uint32_t new_capacity) {
+  if (new_capacity <= capacity_) {
+    return;
+  }
+
+  uint32_t added = new_capacity - capacity_;
+  if (!free_ranges_.empty() && free_ranges_.back().offset + free_ranges_.back().size == capacity_) {
+    free_ranges_.back().size += added;
+  }
+  else {
+    free_ranges_.push_back({ capacity_, added });
+  }
+  capacity_ = new_capacity;
+}
+
+uint32_t RangeAllocator::GetLargestFreeRange() const {
+  uint32_t largest = 0;
+  for (const Range& range : free_ranges_) {
+    largest = std::max(largest, range.size);
+  }
+  return largest;
+}
+
+uint32_t RangeAllocator::GetUsedEnd() const {
+  if (!free_ranges_.empty() && free_ranges_.back().offset + free_ranges_.back().size == capacity_) {
+    return free_ranges_.back().offset;
+  }
+  return capacity_;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hands out ranges of a linear resource such as a vertex or index buffer. Free space is kept as a list of ranges
+// sorted by offset and allocated first fit. Freed ranges are merged with free neighbours, so churn doesn't leave the
+// space cut into slivers. Knows nothing about what the ranges hold, so it can be exercised without a GPU
+class RangeAllocator {
+public:
+  static constexpr uint32_t kInvalidOffset = UINT32_MAX;
+
+  explicit RangeAllocator(uint32_t capacity = 0);
+
+  // Returns the offset of a range of size units, or kInvalidOffset if no free range is large enough
+  uint32_t Allocate(uint32_t size);
+  // offset and size must describe a range returned by Allocate
+  void Free(uint32_t offset, uint32_t size);
+  // Adds free space to the end. new_capacity must not be less than the current capacity
+  void Grow(uint32_t new_capacity);
+
+  inline uint32_t GetCapacity() const { return capacity_; }
+  inline uint32_t GetUsed() const { return used_; }
+  inline size_t GetNumFreeRanges() const { return free_ranges_.size(); }
+  uint32_t GetLargestFreeRange() const;
+  // One past the last allocated unit. Everything from here to the capacity is free
+  uint32_t GetUsedEnd() const;
+
+private:
+  struct Range {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  uint32_t capacity_ = 0;
+  uint32_t used_ = 0;
+  std::vector<Range> free_ranges_;
+};
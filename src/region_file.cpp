@@ -0,0 +1,191 @@
+#include "region_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+const char kMagic[4] = { 'C', 'C', 'R', 'G' };
+const uint32_t kFileVersion = 1;
+const size_t kHeaderSize = sizeof(kMagic) + sizeof(uint32_t);
+const size_t kTableEntrySize = 8;
+const size_t kTableOffset = kHeaderSize;
+const size_t kDataOffset = kTableOffset + RegionFile::kChunksPerRegion * kTableEntrySize;
+
+// Room given to an appended payload: a quarter again, rounded up to 64 bytes, so that a chunk growing a little from an
+// edit still fits when it is next written
+static inline uint64_t SlotCapacity(size_t size) {
+  return ((uint64_t)size + size / 4 + 63) & ~(uint64_t)63;
+}
+
+// The file format is little endian regardless of the host
+static inline void PutU32(uint8_t* out, uint32_t value) {
+  out[0] = (uint8_t)value; out[1] = (uint8_t)(value >> 8); out[2] = (uint8_t)(value >> 16); out[3] = (uint8_t)(value >> 24);
+}
+
+static inline uint32_t GetU32(const uint8_t* in) {
+  return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+RegionFile::RegionFile(const std::string& path) {
+#ifdef _WIN32
+  fd_ = _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+  file_size_ = fd_ >= 0 ? (uint64_t)_lseeki64(fd_, 0, SEEK_END) : 0;
+#else
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  file_size_ = fd_ >= 0 ? (uint64_t)lseek(fd_, 0, SEEK_END) : 0;
+#endif
+  if (fd_ < 0) {
+    return;
+  }
+
+  // A new file gets a header and an empty table
+  if (file_size_ == 0) {
+    std::vector<uint8_t> header(kDataOffset, 0);
+    memcpy(header.data(), kMagic, sizeof(kMagic));
+    PutU32(header.data() + sizeof(kMagic), kFileVersion);
+    if (!WriteAt(0, header.data(), header.size())) {
+      return;
+    }
+    file_size_ = kDataOffset;
+    return;
+  }
+
+  std::vector<uint8_t> header(kDataOffset);
+  if (file_size_ < kDataOffset || !ReadAt(0, header.data(), header.size())
+   || memcmp(header.data(), kMagic, sizeof(kMagic)) != 0 || GetU32(header.data() + sizeof(kMagic)) != kFileVersion) {
+    // Not a region file we understand. Leave it alone rather than risk overwriting someone else's data
+#ifdef _WIN32
+    _close(fd_);
+#else
+    close(fd_);
+#endif
+    fd_ = -1;
+    return;
+  }
+
+  for (int i = 0; i < kChunksPerRegion; ++i) {
+    const uint8_t* entry = header.data() + kTableOffset + i * kTableEntrySize;
+    table_[i].offset = GetU32(entry);
+    table_[i].size = GetU32(entry + 4);
+  }
+
+  // A slot reaches up to the payload after it, which takes in any space left by payloads that have since moved
+  int used[kChunksPerRegion];
+  int num_used = 0;
+  for (int i = 0; i < kChunksPerRegion; ++i) {
+    if (table_[i].size > 0) {
+      used[num_used++] = i;
+    }
+  }
+  std::sort(used, used + num_used, [this](int a, int b){ return table_[a].offset < table_[b].offset; });
+  for (int i = 0; i < num_used; ++i) {
+    TableEntry& entry = table_[used[i]];
+    uint64_t end = i + 1 < num_used ? table_[used[i + 1]].offset : file_size_;
+    // Overlapping payloads, only found in a damaged file, get no room to grow
+    entry.capacity = end > entry.offset ? (uint32_t)std::max<uint64_t>(end - entry.offset, entry.size) : entry.size;
+  }
+}
+
+RegionFile::~RegionFile() {
+  if (fd_ >= 0) {
+#ifdef _WIN32
+    _close(fd_);
+#else
+    close(fd_);
+#endif
+  }
+}
+
+bool RegionFile::Read(int local_index, std::vector<uint8_t>& payload) {
+  std::shared_lock<std::shared_mutex> lock(table_mutex_);
+  const TableEntry& entry = table_[local_index];
+  if (entry.size == 0) {
+    return false;
+  }
+
+  payload.resize(entry.size);
+  return ReadAt(entry.offset, payload.data(), entry.size);
+}
+
+bool RegionFile::Write(int local_index, const std::vector<uint8_t>& payload) {
+  if (payload.empty()) {
+    return false;
+  }
+
+  // Writes come from a single thread, so the table and file_size_ can be read here without a lock
+  TableEntry entry = table_[local_index];
+  if (payload.size() <= entry.capacity) {
+    // Readers are kept out while the old payload is overwritten. A failed write leaves a payload that won't decode,
+    // which loads treat as a missing chunk
+    std::unique_lock<std::shared_mutex> lock(table_mutex_);
+    if (!WriteAt(entry.offset, payload.data(), payload.size())) {
+      return false;
+    }
+    table_[local_index].size = (uint32_t)payload.size();
+    entry = table_[local_index];
+  }
+  else {
+    // Nothing reads past the end of the file, so an appended payload needs no lock until the table points at it
+    uint64_t offset = file_size_;
+    uint64_t capacity = SlotCapacity(payload.size());
+    if (offset + capacity > UINT32_MAX || !WriteAt(offset, payload.data(), payload.size())) {
+      return false;
+    }
+    file_size_ += capacity;
+
+    entry.offset = (uint32_t)offset;
+    entry.size = (uint32_t)payload.size();
+    entry.capacity = (uint32_t)capacity;
+    std::unique_lock<std::shared_mutex> lock(table_mutex_);
+    table_[local_index] = entry;
+  }
+
+  uint8_t encoded_entry[kTableEntrySize];
+  PutU32(encoded_entry, entry.offset);
+  PutU32(encoded_entry + 4, entry.size);
+  return WriteAt(kTableOffset + local_index * kTableEntrySize, encoded_entry, sizeof(encoded_entry));
+}
+
+bool RegionFile::ReadAt(uint64_t offset, void* data, size_t size) {
+#ifdef _WIN32
+  std::lock_guard<std::mutex> lock(io_mutex_);
+  return _lseeki64(fd_, (__int64)offset, SEEK_SET) >= 0 && _read(fd_, data, (unsigned int)size) == (int)size;
+#else
+  uint8_t* bytes = (uint8_t*)data;
+  while (size > 0) {
+    ssize_t count = pread(fd_, bytes, size, (off_t)offset);
+    if (count <= 0) {
+      return false;
+    }
+    bytes += count;
+    offset += count;
+    size -= count;
+  }
+  return true;
+#endif
+}
+
+bool RegionFile::WriteAt(uint64_t offset, const void* data, size_t size) {
+#ifdef _WIN32
+  std::lock_guard<std::mutex> lock(io_mutex_);
+  return _lseeki64(fd_, (__int64)offset, SEEK_SET) >= 0 && _write(fd_, data, (unsigned int)size) == (int)size;
+#else
+  const uint8_t* bytes = (const uint8_t*)data;
+  while (size > 0) {
+    ssize_t count = pwrite(fd_, bytes, size, (off_t)offset);
+    if (count <= 0) {
+      return false;
+    }
+    bytes += count;
+    offset += count;
+    size -= count;
+  }
+  return true;
+#endif
+}
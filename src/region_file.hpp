@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// A file holding up to kChunksPerRegion encoded chunks from a kRegionSize^3 block of chunk space. The file starts with
+// a header and a table of (offset, size) entries, one per chunk, followed by chunk payloads. Payloads are appended with
+// some room to grow, and a rewritten chunk goes back into its old slot if it fits, otherwise it is appended and its
+// table entry repointed. Reads use positioned I/O, so any number of threads can read while one thread writes.
+class RegionFile {
+public:
+  static constexpr int kRegionSize = 8;
+  static constexpr int kChunksPerRegion = kRegionSize * kRegionSize * kRegionSize;
+
+  // Opens the file at path, creating it if it doesn't exist. Check IsOpen afterwards
+  explicit RegionFile(const std::string& path);
+  ~RegionFile();
+
+  RegionFile(const RegionFile&) = delete;
+  RegionFile& operator=(const RegionFile&) = delete;
+
+  inline bool IsOpen() const { return fd_ >= 0; }
+
+  // Index of a chunk within its region, from chunk-local coordinates 0 to kRegionSize - 1
+  static inline int LocalIndex(int x, int y, int z) { return x + y * kRegionSize + z * kRegionSize * kRegionSize; }
+
+  // Returns false if the chunk has never been written
+  bool Read(int local_index, std::vector<uint8_t>& payload);
+  bool Write(int local_index, const std::vector<uint8_t>& payload);
+
+private:
+  struct TableEntry {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    uint32_t capacity = 0; // Bytes the slot has room for, up to the next payload. Not stored in the file
+  };
+
+  bool ReadAt(uint64_t offset, void* data, size_t size);
+  bool WriteAt(uint64_t offset, const void* data, size_t size);
+
+private:
+  int fd_ = -1;
+  uint64_t file_size_ = 0;
+
+  std::shared_mutex table_mutex_; // Held shared while reading a payload, as a rewrite in place would tear it
+  TableEntry table_[kChunksPerRegion];
+
+#ifdef _WIN32
+  std::mutex io_mutex_; // The CRT has no positioned I/O, so seek and read/write must not interleave
+#endif
+};
@@ -0,0 +1,175 @@
+#include "region_store.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "chunk_codec.hpp"
+#include "chunk_constants.hpp"
+
+const size_t kNumBlocks = ChunkConstants::kChunkSize * ChunkConstants::kChunkSize * ChunkConstants::kChunkSize;
+// Each open region holds a file descriptor, so only the regions around the camera are kept open
+const size_t kMaxOpenRegions = 32;
+// Forgotten all at once past this, which at worst costs one filesystem check per region to find them missing again
+const size_t kMaxMissingRegions = 4096;
+
+// Floor division, so that chunk -1 lands in region -1 rather than region 0
+static inline int RegionCoord(int chunk_coord) {
+  return chunk_coord >= 0 ? chunk_coord / RegionFile::kRegionSize
+                          : (chunk_coord - RegionFile::kRegionSize + 1) / RegionFile::kRegionSize;
+}
+
+static inline int LocalCoord(int chunk_coord) {
+  return chunk_coord - RegionCoord(chunk_coord) * RegionFile::kRegionSize;
+}
+
+RegionStore::RegionStore(const std::string& directory) : directory_(directory) {
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+
+  writer_ = std::thread(&RegionStore::WriterLoop, this);
+}
+
+RegionStore::~RegionStore() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_writer_.notify_one();
+  writer_.join();
+}
+
+bool RegionStore::LoadChunk(int chunk_x, int chunk_y, int chunk_z, Block* blocks) {
+  // Kept per thread so that, once it has held the largest payload, loading allocates nothing
+  thread_local std::vector<uint8_t> payload;
+  payload.clear();
+  {
+    // The newest copy of a chunk is the one waiting to be written, then the one being written, then the one on disk
+    std::lock_guard<std::mutex> lock(mutex_);
+    const PendingWrite* pending = pending_writes_.Find(chunk_x, chunk_y, chunk_z);
+    if (!pending) {
+      pending = writing_.Find(chunk_x, chunk_y, chunk_z);
+    }
+    if (pending) {
+      payload = pending->payload;
+    }
+  }
+
+  if (payload.empty()) {
+    std::shared_ptr<RegionFile> region = GetRegion(chunk_x, chunk_y, chunk_z, false);
+    if (!region || !region->Read(RegionFile::LocalIndex(LocalCoord(chunk_x), LocalCoord(chunk_y), LocalCoord(chunk_z)), payload)) {
+      return false;
+    }
+  }
+
+  // A corrupt chunk is treated as missing, so it gets generated again and overwritten
+  Block decoded[kNumBlocks];
+  if (!ChunkCodec::Decode(payload.data(), payload.size(), decoded)) {
+    return false;
+  }
+  std::copy(decoded, decoded + kNumBlocks, blocks);
+  return true;
+}
+
+void RegionStore::StoreChunk(int chunk_x, int chunk_y, int chunk_z, const Block* blocks) {
+  PendingWrite write;
+  write.chunk_x = chunk_x;
+  write.chunk_y = chunk_y;
+  write.chunk_z = chunk_z;
+  ChunkCodec::Encode(blocks, write.payload);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PendingWrite* existing = pending_writes_.Find(chunk_x, chunk_y, chunk_z);
+    if (existing) {
+      *existing = std::move(write);
+    }
+    else {
+      pending_writes_.Insert(chunk_x, chunk_y, chunk_z, std::move(write));
+    }
+  }
+  wake_writer_.notify_one();
+}
+
+void RegionStore::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  wake_flushers_.wait(lock, [this](){ return pending_writes_.Empty() && writing_.Empty(); });
+}
+
+std::shared_ptr<RegionFile> RegionStore::GetRegion(int chunk_x, int chunk_y, int chunk_z, bool create) {
+  int region_x = RegionCoord(chunk_x), region_y = RegionCoord(chunk_y), region_z = RegionCoord(chunk_z);
+
+  std::lock_guard<std::mutex> lock(regions_mutex_);
+  OpenRegion* region = regions_.Find(region_x, region_y, region_z);
+  if (region) {
+    region->last_used = ++region_uses_;
+    return region->file;
+  }
+  if (!create && missing_regions_.Find(region_x, region_y, region_z)) {
+    return nullptr;
+  }
+
+  std::string path = directory_ + "/r." + std::to_string(region_x) + "." + std::to_string(region_y) + "."
+                   + std::to_string(region_z) + ".ccr";
+  std::error_code error;
+  if (!create && !std::filesystem::exists(path, error)) {
+    if (missing_regions_.Size() >= kMaxMissingRegions) {
+      missing_regions_.Clear();
+    }
+    missing_regions_.Insert(region_x, region_y, region_z, true);
+    return nullptr;
+  }
+  auto file = std::make_shared<RegionFile>(path);
+  if (!file->IsOpen()) {
+    return nullptr;
+  }
+  missing_regions_.Erase(region_x, region_y, region_z);
+
+  // Only a region nothing else holds is closed. One still being read or written would otherwise be opened a second
+  // time by the next caller, with a table and end of file that miss the first one's writes, and the two would write
+  // over each other. If every region is in use the cap is exceeded until some are let go
+  if (regions_.Size() >= kMaxOpenRegions) {
+    const OpenRegion* oldest = nullptr;
+    regions_.ForEach([&](const OpenRegion& open){
+      if (open.file.use_count() == 1 && (!oldest || open.last_used < oldest->last_used)) {
+        oldest = &open;
+      }
+    });
+    if (oldest) {
+      regions_.Erase(oldest->region_x, oldest->region_y, oldest->region_z);
+    }
+  }
+
+  OpenRegion opened;
+  opened.region_x = region_x;
+  opened.region_y = region_y;
+  opened.region_z = region_z;
+  opened.last_used = ++region_uses_;
+  opened.file = std::move(file);
+  return regions_.Insert(region_x, region_y, region_z, std::move(opened)).file;
+}
+
+void RegionStore::WriterLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_writer_.wait(lock, [this](){ return stopping_ || !pending_writes_.Empty(); });
+    if (pending_writes_.Empty()) {
+      // Only reached when stopping, after everything stored has been written
+      return;
+    }
+
+    std::swap(pending_writes_, writing_);
+    lock.unlock();
+
+    writing_.ForEach([this](PendingWrite& write){
+      std::shared_ptr<RegionFile> region = GetRegion(write.chunk_x, write.chunk_y, write.chunk_z, true);
+      if (region) {
+        region->Write(RegionFile::LocalIndex(LocalCoord(write.chunk_x), LocalCoord(write.chunk_y),
+          LocalCoord(write.chunk_z)), write.payload);
+      }
+    });
+
+    lock.lock();
+    writing_.Clear();
+    wake_flushers_.notify_all();
+  }
+}
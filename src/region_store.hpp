@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "block.hpp"
+#include "chunk_map.hpp"
+#include "region_file.hpp"
+
+// Saves generated chunks to region files in a directory and loads them back. Safe to call from any thread. Chunks are
+// encoded on the calling thread and written by a background thread, so storing never waits on the disk. Loads see
+// chunks that have been stored but not yet written
+class RegionStore {
+public:
+  explicit RegionStore(const std::string& directory);
+  // Writes any chunks still waiting to be written
+  ~RegionStore();
+
+  RegionStore(const RegionStore&) = delete;
+  RegionStore& operator=(const RegionStore&) = delete;
+
+  // Returns false if the chunk has not been stored, in which case blocks is left untouched
+  bool LoadChunk(int chunk_x, int chunk_y, int chunk_z, Block* blocks);
+  void StoreChunk(int chunk_x, int chunk_y, int chunk_z, const Block* blocks);
+
+  // Blocks until every chunk stored so far has been written
+  void Flush();
+
+private:
+  struct PendingWrite {
+    int chunk_x = 0, chunk_y = 0, chunk_z = 0;
+    std::vector<uint8_t> payload;
+  };
+
+  // Regions kept open, the least recently used that no caller still holds closed to make room for another. There is
+  // never more than one RegionFile for a region at a time
+  struct OpenRegion {
+    int region_x = 0, region_y = 0, region_z = 0;
+    uint64_t last_used = 0;
+    std::shared_ptr<RegionFile> file;
+  };
+
+  // Returns nullptr if the region can't be opened, or doesn't exist yet and create is false
+  std::shared_ptr<RegionFile> GetRegion(int chunk_x, int chunk_y, int chunk_z, bool create);
+  void WriterLoop();
+
+private:
+  std::string directory_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_writer_;
+  std::condition_variable wake_flushers_;
+  ChunkMap<PendingWrite> pending_writes_; // Stored, waiting for the writer
+  ChunkMap<PendingWrite> writing_;        // Taken by the writer, not yet in a region file
+  bool stopping_ = false;
+
+  std::mutex regions_mutex_;
+  ChunkMap<OpenRegion> regions_;
+  ChunkMap<bool> missing_regions_; // Found not to exist, so loads from them skip asking the filesystem
+  uint64_t region_uses_ = 0;
+
+  std::thread writer_;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// First in, first out queue over a ring of slots that doubles when full. std::deque frees and allocates blocks as its
+// ends move along, whereas this stops allocating once it has grown to the longest the queue gets
+template <typename T>
+class RingQueue {
+public:
+  inline bool Empty() const { return size_ == 0; }
+  inline size_t Size() const { return size_; }
+
+  inline T& Front() { return slots_[head_]; }
+  inline const T& Front() const { return slots_[head_]; }
+
+  void PushBack(T value) {
+    if (size_ == slots_.size()) {
+      Grow();
+    }
+    slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(value);
+    ++size_;
+  }
+
+  void PopFront() {
+    slots_[head_] = T();
+    head_ = (head_ + 1) & (slots_.size() - 1);
+    --size_;
+  }
+
+  // Keeps the slots for reuse
+  void Clear() {
+    while (!Empty()) {
+      PopFront();
+    }
+    head_ = 0;
+  }
+
+private:
+  void Grow() {
+    std::vector<T> grown(std::max<size_t>(kMinCapacity, slots_.size() * 2));
+    for (size_t i = 0; i < size_; ++i) {
+      grown[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+    }
+    slots_.swap(grown);
+    head_ = 0;
+  }
+
+private:
+  static constexpr size_t kMinCapacity = 16;
+
+  std::vector<T> slots_; // Always a power of two long
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
@@ -3,14 +3,15 @@
 layout (location = 0) out vec4 o_colour;
 
 layout (location = 0) in vec3 v_tex;
-layout (location = 1) flat in float v_norm;
+layout (location = 1) in float v_light;
 
 layout (binding = 1) uniform sampler2DArray u_block_texture_array;
 
 void main() {
-  o_colour = texture(u_block_texture_array, v_tex);
+  // Greedy meshed quads carry UVs larger than 1 so the texture repeats once per block
+  o_colour = texture(u_block_texture_array, vec3(fract(v_tex.xy), v_tex.z));
   if (o_colour.a < 0.5) {
     discard;
   }
-  o_colour.rgb *= v_norm;
+  o_colour.rgb *= v_light;
 }
@@ -1,18 +1,48 @@
 #version 450
 
-layout (location = 0) in vec3  a_pos;
-layout (location = 1) in vec3  a_tex;
-layout (location = 2) in float a_norm;
+// Packed vertex, see chunk_vertex.hpp for the layout. Each component holds an integer small enough to be exact in a
+// float
+layout (location = 0) in vec2 a_packed;
 
 layout (location = 0) out vec3 v_tex;
-layout (location = 1) flat out float v_norm;
+layout (location = 1) out float v_light; // Interpolated between corners for smooth lighting
 
 layout (binding = 0) uniform ViewProjectionMatrix {
   mat4 matrix;
 } u_viewprojection;
 
+// Chunk meshes are drawn a page at a time, see chunk_mesh_pool.hpp. w scales ChunkLod node meshes up to world size
+layout (binding = 2) uniform PageOrigin {
+  vec4 origin;
+} u_page_origin;
+
+// Bit n set if the chunk in slot n of the page is to be drawn. calcium can only draw a page's whole index buffer, so
+// the others are culled here, see chunk_mesh_pool.hpp
+layout (binding = 3) uniform PageVisibility {
+  uvec2 slots;
+} u_page_visibility;
+
+const float kChunkSize = 12.0; // Must match ChunkConstants::kChunkSize
+
 void main() {
-  gl_Position = u_viewprojection.matrix * vec4(a_pos, 1.0);
-  v_tex = a_tex;
-  v_norm = a_norm;
+  uint position = uint(a_packed.x);
+  uint material = uint(a_packed.y);
+
+  vec3 pos = vec3(position & 0xfu, (position >> 4) & 0xfu, (position >> 8) & 0xfu);
+  vec2 uv = vec2((position >> 12) & 0xfu, (position >> 16) & 0xfu);
+  vec3 chunk_offset = vec3((material >> 16) & 0x3u, (material >> 18) & 0x3u, (material >> 20) & 0x3u) * kChunkSize;
+
+  uint slot = (material >> 16) & 0x3fu;
+  uint visible = slot < 32u ? (u_page_visibility.slots.x >> slot) : (u_page_visibility.slots.y >> (slot - 32u));
+  if ((visible & 1u) == 0u) {
+    // Every vertex of the chunk lands on the same point, so its triangles have no area and are dropped
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+    v_tex = vec3(0.0);
+    v_light = 0.0;
+    return;
+  }
+
+  gl_Position = u_viewprojection.matrix * vec4(u_page_origin.origin.xyz + (chunk_offset + pos) * u_page_origin.origin.w, 1.0);
+  v_tex = vec3(uv, float(material & 0xffu));
+  v_light = float((material >> 8) & 0xffu) / 255.0;
 }
@@ -0,0 +1,318 @@
+#include "simplex_noise.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define CALCIUM_SIMPLEX_SSE2 1
+  #include <emmintrin.h>
+#endif
+
+namespace {
+
+const float kSkew2 = 0.36602540378f;   // (sqrt(3) - 1) / 2
+const float kUnskew2 = 0.21132486540f; // (3 - sqrt(3)) / 6
+const float kSkew3 = 1.0f / 3.0f;
+const float kUnskew3 = 1.0f / 6.0f;
+
+// Ken Perlin's reference permutation
+const uint8_t kPermutation[256] = {
+  151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225, 140,  36, 103,  30,  69, 142,
+    8,  99,  37, 240,  21,  10,  23, 190,   6, 148, 247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203,
+  117,  35,  11,  32,  57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,  74, 165,
+   71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,  60, 211, 133, 230, 220, 105,  92,  41,
+   55,  46, 245,  40, 244, 102, 143,  54,  65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,
+   18, 169, 200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,  52, 217, 226, 250,
+  124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212, 207, 206,  59, 227,  47,  16,  58,  17, 182, 189,
+   28,  42, 223, 183, 170, 213, 119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+  129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104, 218, 246,  97, 228, 251,  34,
+  242, 193, 238, 210, 144,  12, 191, 179, 162, 241,  81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31,
+  181, 199, 106, 157, 184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93, 222, 114,
+   67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180,
+};
+
+// The twelve edge midpoints of a cube. 2D noise uses their x and y
+const float kGradientX[12] = { 1, -1,  1, -1, 1, -1,  1, -1, 0,  0,  0,  0 };
+const float kGradientY[12] = { 1,  1, -1, -1, 0,  0,  0,  0, 1, -1,  1, -1 };
+const float kGradientZ[12] = { 0,  0,  0,  0, 1,  1, -1, -1, 1,  1, -1, -1 };
+
+// The permutation twice over, so a lattice coordinate plus a permuted one never needs wrapping, and the gradient each
+// entry picks
+struct Tables {
+  constexpr Tables() {
+    for (int i = 0; i < 512; ++i) {
+      permutation[i] = kPermutation[i & 255];
+      gradient[i] = (uint8_t)(permutation[i] % 12);
+    }
+  }
+
+  uint8_t permutation[512] = { };
+  uint8_t gradient[512] = { };
+};
+constexpr Tables kTables;
+
+inline int FastFloor(float x) {
+  int i = (int)x;
+  return x < (float)i ? i - 1 : i;
+}
+
+// Lattice coordinates are wrapped to 0-255 by the caller
+inline int Gradient2d(int i, int j) { return kTables.gradient[i + kTables.permutation[j]]; }
+inline int Gradient3d(int i, int j, int k) {
+  return kTables.gradient[i + kTables.permutation[j + kTables.permutation[k]]];
+}
+
+// Which of the six tetrahedra of the skewed cube the point is in, as the steps from the first corner to the second
+// and to the third
+inline void Steps3d(bool x_ge_y, bool x_ge_z, bool y_ge_z, int step1[3], int step2[3]) {
+  step1[0] = x_ge_y && x_ge_z;
+  step1[1] = !x_ge_y && y_ge_z;
+  step1[2] = !x_ge_z && !y_ge_z;
+  step2[0] = x_ge_y || x_ge_z;
+  step2[1] = !x_ge_y || y_ge_z;
+  step2[2] = !x_ge_z || !y_ge_z;
+}
+
+inline float Corner2d(float x, float y, int gradient) {
+  float t = 0.5f - x * x - y * y;
+  if (t < 0.0f) {
+    return 0.0f;
+  }
+  t *= t;
+  return t * t * (kGradientX[gradient] * x + kGradientY[gradient] * y);
+}
+
+inline float Corner3d(float x, float y, float z, int gradient) {
+  float t = 0.6f - x * x - y * y - z * z;
+  if (t < 0.0f) {
+    return 0.0f;
+  }
+  t *= t;
+  return t * t * (kGradientX[gradient] * x + kGradientY[gradient] * y + kGradientZ[gradient] * z);
+}
+
+#ifdef CALCIUM_SIMPLEX_SSE2
+// The same sums in the same order as the scalar code, so all four lanes round as it does. There are no SSE2 gathers,
+// so the lattice and gradient lookups are done a lane at a time between the vector arithmetic
+
+inline __m128i FastFloor(__m128 x) {
+  // Truncation rounds negative values up, which the all-ones compare mask takes one off again
+  __m128i i = _mm_cvttps_epi32(x);
+  return _mm_add_epi32(i, _mm_castps_si128(_mm_cmplt_ps(x, _mm_cvtepi32_ps(i))));
+}
+
+inline __m128 LoadGradients(const float* components, const int gradients[4]) {
+  return _mm_setr_ps(components[gradients[0]], components[gradients[1]], components[gradients[2]],
+                     components[gradients[3]]);
+}
+
+inline __m128 Corner2d(__m128 x, __m128 y, const int gradients[4]) {
+  __m128 t = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.5f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y));
+  __m128 dot = _mm_add_ps(_mm_mul_ps(LoadGradients(kGradientX, gradients), x),
+                          _mm_mul_ps(LoadGradients(kGradientY, gradients), y));
+  __m128 t2 = _mm_mul_ps(t, t);
+  return _mm_andnot_ps(_mm_cmplt_ps(t, _mm_setzero_ps()), _mm_mul_ps(_mm_mul_ps(t2, t2), dot));
+}
+
+inline __m128 Corner3d(__m128 x, __m128 y, __m128 z, const int gradients[4]) {
+  __m128 t = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.6f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y)),
+                        _mm_mul_ps(z, z));
+  __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(LoadGradients(kGradientX, gradients), x),
+                                     _mm_mul_ps(LoadGradients(kGradientY, gradients), y)),
+                          _mm_mul_ps(LoadGradients(kGradientZ, gradients), z));
+  __m128 t2 = _mm_mul_ps(t, t);
+  return _mm_andnot_ps(_mm_cmplt_ps(t, _mm_setzero_ps()), _mm_mul_ps(_mm_mul_ps(t2, t2), dot));
+}
+
+inline __m128 LoadSteps(const int steps[4]) {
+  return _mm_cvtepi32_ps(_mm_setr_epi32(steps[0], steps[1], steps[2], steps[3]));
+}
+
+void Noise2d4(const float* xs, const float* ys, float* out) {
+  __m128 x = _mm_loadu_ps(xs);
+  __m128 y = _mm_loadu_ps(ys);
+  __m128 one = _mm_set1_ps(1.0f);
+
+  __m128 s = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(kSkew2));
+  __m128i i = FastFloor(_mm_add_ps(x, s));
+  __m128i j = FastFloor(_mm_add_ps(y, s));
+  __m128 fi = _mm_cvtepi32_ps(i);
+  __m128 fj = _mm_cvtepi32_ps(j);
+  __m128 t = _mm_mul_ps(_mm_add_ps(fi, fj), _mm_set1_ps(kUnskew2));
+  __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(fi, t));
+  __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(fj, t));
+
+  int lattice_i[4], lattice_j[4];
+  _mm_storeu_si128((__m128i*)lattice_i, _mm_and_si128(i, _mm_set1_epi32(255)));
+  _mm_storeu_si128((__m128i*)lattice_j, _mm_and_si128(j, _mm_set1_epi32(255)));
+  int x_gt_y = _mm_movemask_ps(_mm_cmpgt_ps(x0, y0));
+
+  int step_x[4], step_y[4], gradients0[4], gradients1[4], gradients2[4];
+  for (int lane = 0; lane < 4; ++lane) {
+    int ii = lattice_i[lane], jj = lattice_j[lane];
+    step_x[lane] = (x_gt_y >> lane) & 1;
+    step_y[lane] = 1 - step_x[lane];
+    gradients0[lane] = Gradient2d(ii, jj);
+    gradients1[lane] = Gradient2d(ii + step_x[lane], jj + step_y[lane]);
+    gradients2[lane] = Gradient2d(ii + 1, jj + 1);
+  }
+
+  __m128 unskew = _mm_set1_ps(kUnskew2);
+  __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, LoadSteps(step_x)), unskew);
+  __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, LoadSteps(step_y)), unskew);
+  __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, one), _mm_set1_ps(2.0f * kUnskew2));
+  __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, one), _mm_set1_ps(2.0f * kUnskew2));
+
+  __m128 n = _mm_add_ps(_mm_add_ps(Corner2d(x0, y0, gradients0), Corner2d(x1, y1, gradients1)),
+                        Corner2d(x2, y2, gradients2));
+  _mm_storeu_ps(out, _mm_mul_ps(_mm_set1_ps(70.0f), n));
+}
+
+void Noise3d4(const float* xs, const float* ys, const float* zs, float* out) {
+  __m128 x = _mm_loadu_ps(xs);
+  __m128 y = _mm_loadu_ps(ys);
+  __m128 z = _mm_loadu_ps(zs);
+  __m128 one = _mm_set1_ps(1.0f);
+
+  __m128 s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), _mm_set1_ps(kSkew3));
+  __m128i i = FastFloor(_mm_add_ps(x, s));
+  __m128i j = FastFloor(_mm_add_ps(y, s));
+  __m128i k = FastFloor(_mm_add_ps(z, s));
+  __m128 fi = _mm_cvtepi32_ps(i);
+  __m128 fj = _mm_cvtepi32_ps(j);
+  __m128 fk = _mm_cvtepi32_ps(k);
+  __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(fi, fj), fk), _mm_set1_ps(kUnskew3));
+  __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(fi, t));
+  __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(fj, t));
+  __m128 z0 = _mm_sub_ps(z, _mm_sub_ps(fk, t));
+
+  int lattice_i[4], lattice_j[4], lattice_k[4];
+  _mm_storeu_si128((__m128i*)lattice_i, _mm_and_si128(i, _mm_set1_epi32(255)));
+  _mm_storeu_si128((__m128i*)lattice_j, _mm_and_si128(j, _mm_set1_epi32(255)));
+  _mm_storeu_si128((__m128i*)lattice_k, _mm_and_si128(k, _mm_set1_epi32(255)));
+  int x_ge_y = _mm_movemask_ps(_mm_cmpge_ps(x0, y0));
+  int x_ge_z = _mm_movemask_ps(_mm_cmpge_ps(x0, z0));
+  int y_ge_z = _mm_movemask_ps(_mm_cmpge_ps(y0, z0));
+
+  int steps1[3][4], steps2[3][4], gradients0[4], gradients1[4], gradients2[4], gradients3[4];
+  for (int lane = 0; lane < 4; ++lane) {
+    int step1[3], step2[3];
+    Steps3d((x_ge_y >> lane) & 1, (x_ge_z >> lane) & 1, (y_ge_z >> lane) & 1, step1, step2);
+    for (int axis = 0; axis < 3; ++axis) {
+      steps1[axis][lane] = step1[axis];
+      steps2[axis][lane] = step2[axis];
+    }
+
+    int ii = lattice_i[lane], jj = lattice_j[lane], kk = lattice_k[lane];
+    gradients0[lane] = Gradient3d(ii, jj, kk);
+    gradients1[lane] = Gradient3d(ii + step1[0], jj + step1[1], kk + step1[2]);
+    gradients2[lane] = Gradient3d(ii + step2[0], jj + step2[1], kk + step2[2]);
+    gradients3[lane] = Gradient3d(ii + 1, jj + 1, kk + 1);
+  }
+
+  __m128 unskew1 = _mm_set1_ps(kUnskew3);
+  __m128 unskew2 = _mm_set1_ps(2.0f * kUnskew3);
+  __m128 unskew3 = _mm_set1_ps(3.0f * kUnskew3);
+  __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, LoadSteps(steps1[0])), unskew1);
+  __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, LoadSteps(steps1[1])), unskew1);
+  __m128 z1 = _mm_add_ps(_mm_sub_ps(z0, LoadSteps(steps1[2])), unskew1);
+  __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, LoadSteps(steps2[0])), unskew2);
+  __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, LoadSteps(steps2[1])), unskew2);
+  __m128 z2 = _mm_add_ps(_mm_sub_ps(z0, LoadSteps(steps2[2])), unskew2);
+  __m128 x3 = _mm_add_ps(_mm_sub_ps(x0, one), unskew3);
+  __m128 y3 = _mm_add_ps(_mm_sub_ps(y0, one), unskew3);
+  __m128 z3 = _mm_add_ps(_mm_sub_ps(z0, one), unskew3);
+
+  __m128 n = _mm_add_ps(_mm_add_ps(_mm_add_ps(Corner3d(x0, y0, z0, gradients0), Corner3d(x1, y1, z1, gradients1)),
+                                   Corner3d(x2, y2, z2, gradients2)),
+                        Corner3d(x3, y3, z3, gradients3));
+  _mm_storeu_ps(out, _mm_mul_ps(_mm_set1_ps(32.0f), n));
+}
+#endif
+
+}
+
+namespace SimplexNoise {
+
+float Noise2d(float x, float y) {
+  // Skew the point onto a lattice of squares each split into two triangles, and find the triangle it is in
+  float s = (x + y) * kSkew2;
+  int i = FastFloor(x + s);
+  int j = FastFloor(y + s);
+  float t = ((float)i + (float)j) * kUnskew2;
+  float x0 = x - ((float)i - t);
+  float y0 = y - ((float)j - t);
+
+  // Below the diagonal the middle corner is a step along x, otherwise along y
+  int step_x = x0 > y0;
+  int step_y = 1 - step_x;
+  float x1 = x0 - (float)step_x + kUnskew2;
+  float y1 = y0 - (float)step_y + kUnskew2;
+  float x2 = x0 - 1.0f + 2.0f * kUnskew2;
+  float y2 = y0 - 1.0f + 2.0f * kUnskew2;
+
+  int ii = i & 255, jj = j & 255;
+  float n = Corner2d(x0, y0, Gradient2d(ii, jj)) + Corner2d(x1, y1, Gradient2d(ii + step_x, jj + step_y))
+          + Corner2d(x2, y2, Gradient2d(ii + 1, jj + 1));
+  return 70.0f * n;
+}
+
+float Noise3d(float x, float y, float z) {
+  // As Noise2d, with the skewed cube split into six tetrahedra
+  float s = (x + y + z) * kSkew3;
+  int i = FastFloor(x + s);
+  int j = FastFloor(y + s);
+  int k = FastFloor(z + s);
+  float t = ((float)i + (float)j + (float)k) * kUnskew3;
+  float x0 = x - ((float)i - t);
+  float y0 = y - ((float)j - t);
+  float z0 = z - ((float)k - t);
+
+  int step1[3], step2[3];
+  Steps3d(x0 >= y0, x0 >= z0, y0 >= z0, step1, step2);
+  float x1 = x0 - (float)step1[0] + kUnskew3;
+  float y1 = y0 - (float)step1[1] + kUnskew3;
+  float z1 = z0 - (float)step1[2] + kUnskew3;
+  float x2 = x0 - (float)step2[0] + 2.0f * kUnskew3;
+  float y2 = y0 - (float)step2[1] + 2.0f * kUnskew3;
+  float z2 = z0 - (float)step2[2] + 2.0f * kUnskew3;
+  float x3 = x0 - 1.0f + 3.0f * kUnskew3;
+  float y3 = y0 - 1.0f + 3.0f * kUnskew3;
+  float z3 = z0 - 1.0f + 3.0f * kUnskew3;
+
+  int ii = i & 255, jj = j & 255, kk = k & 255;
+  float n = Corner3d(x0, y0, z0, Gradient3d(ii, jj, kk))
+          + Corner3d(x1, y1, z1, Gradient3d(ii + step1[0], jj + step1[1], kk + step1[2]))
+          + Corner3d(x2, y2, z2, Gradient3d(ii + step2[0], jj + step2[1], kk + step2[2]))
+          + Corner3d(x3, y3, z3, Gradient3d(ii + 1, jj + 1, kk + 1));
+  return 32.0f * n;
+}
+
+void Noise2d(const float* xs, const float* ys, size_t count, float* out) {
+  size_t i = 0;
+
+#ifdef CALCIUM_SIMPLEX_SSE2
+  for (; i + 4 <= count; i += 4) {
+    Noise2d4(xs + i, ys + i, out + i);
+  }
+#endif
+
+  for (; i < count; ++i) {
+    out[i] = Noise2d(xs[i], ys[i]);
+  }
+}
+
+void Noise3d(const float* xs, const float* ys, const float* zs, size_t count, float* out) {
+  size_t i = 0;
+
+#ifdef CALCIUM_SIMPLEX_SSE2
+  for (; i + 4 <= count; i += 4) {
+    Noise3d4(xs + i, ys + i, zs + i, out + i);
+  }
+#endif
+
+  for (; i < count; ++i) {
+    out[i] = Noise3d(xs[i], ys[i], zs[i]);
+  }
+}
+
+}
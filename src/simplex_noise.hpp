@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+// Simplex noise (Perlin 2001, after Gustavson's reference implementation) over a fixed permutation, so the terrain
+// doesn't depend on how anything was seeded. Values lie roughly in -1 to 1. Safe to call from several threads at once
+namespace SimplexNoise {
+
+float Noise2d(float x, float y);
+float Noise3d(float x, float y, float z);
+
+// Sample count points given as separate coordinate arrays into out. Where SSE2 is available four points are sampled
+// per iteration, doing the same sums as the single point functions. Builds that fuse multiplies and adds may round the
+// two differently in the last bits
+void Noise2d(const float* xs, const float* ys, size_t count, float* out);
+void Noise3d(const float* xs, const float* ys, const float* zs, size_t count, float* out);
+
+}
@@ -0,0 +1,205 @@
+#include "slab_allocator.hpp"
+
+#include <algorithm>
+#include <new>
+
+// Allocators are found by size without a lock, so the first kMaxAllocators are published in a fixed array before
+// the count is raised. Any beyond that are only looked up under the lock
+static SlabAllocator* allocators[SlabAllocator::kMaxAllocators];
+static std::atomic<size_t> num_allocators = 0;
+static std::mutex allocators_mutex;
+static std::vector<SlabAllocator*> overflow_allocators;
+
+// Set once a thread's caches have been handed back, so blocks freed later in its exit (by other thread_local or
+// static destructors) go straight to the shared lists
+static thread_local bool thread_caches_released = false;
+
+thread_local SlabAllocator::ThreadCaches SlabAllocator::thread_caches_;
+
+static inline size_t BlockSizeFor(size_t size) {
+  const size_t kAlign = alignof(std::max_align_t);
+  size = std::max(size, sizeof(void*));
+  return (size + kAlign - 1) / kAlign * kAlign;
+}
+
+SlabAllocator::ThreadCaches::~ThreadCaches() {
+  thread_caches_released = true;
+  size_t count = std::min(num_allocators.load(std::memory_order_acquire), kMaxAllocators);
+  for (size_t i = 0; i < count; ++i) {
+    ThreadCache& cache = caches[i];
+    if (!cache.head) {
+      continue;
+    }
+    FreeBlock* tail = cache.head;
+    while (tail->next) {
+      tail = tail->next;
+    }
+    allocators[i]->PushShared(cache.head, tail, cache.count);
+    cache = ThreadCache();
+  }
+}
+
+SlabAllocator::SlabAllocator(size_t id, size_t size)
+    : id_(id), block_size_(size), blocks_per_slab_(std::max<size_t>(1, kSlabBytes / size)) {
+}
+
+SlabAllocator& SlabAllocator::ForSize(size_t size) {
+  size_t block_size = BlockSizeFor(size);
+  size_t count = std::min(num_allocators.load(std::memory_order_acquire), kMaxAllocators);
+  for (size_t i = 0; i < count; ++i) {
+    if (allocators[i]->block_size_ == block_size) {
+      return *allocators[i];
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(allocators_mutex);
+  count = num_allocators.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < std::min(count, kMaxAllocators); ++i) {
+    if (allocators[i]->block_size_ == block_size) {
+      return *allocators[i];
+    }
+  }
+  for (SlabAllocator* allocator : overflow_allocators) {
+    if (allocator->block_size_ == block_size) {
+      return *allocator;
+    }
+  }
+
+  SlabAllocator* allocator = new SlabAllocator(count, block_size);
+  if (count < kMaxAllocators) {
+    allocators[count] = allocator;
+  }
+  else {
+    overflow_allocators.push_back(allocator);
+  }
+  num_allocators.store(count + 1, std::memory_order_release);
+  return *allocator;
+}
+
+std::vector<SlabAllocator::Stats> SlabAllocator::GetAllStats() {
+  std::vector<Stats> stats;
+  std::lock_guard<std::mutex> lock(allocators_mutex);
+  size_t count = std::min(num_allocators.load(std::memory_order_relaxed), kMaxAllocators);
+  for (size_t i = 0; i < count; ++i) {
+    stats.push_back(allocators[i]->GetStats());
+  }
+  for (SlabAllocator* allocator : overflow_allocators) {
+    stats.push_back(allocator->GetStats());
+  }
+  return stats;
+}
+
+SlabAllocator::ThreadCache* SlabAllocator::GetThreadCache() {
+  if (id_ >= kMaxAllocators || thread_caches_released) {
+    return nullptr;
+  }
+  return &thread_caches_.caches[id_];
+}
+
+void* SlabAllocator::Allocate() {
+  ThreadCache* cache = GetThreadCache();
+  if (!cache || !cache->head) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!cache) {
+      if (!shared_head_) {
+        CountAllocation(false);
+        return AllocateFresh();
+      }
+      FreeBlock* block = shared_head_;
+      shared_head_ = block->next;
+      --shared_count_;
+      CountAllocation(true);
+      return block;
+    }
+
+    // Refill half the thread's list, leaving room for the blocks it frees
+    while (shared_head_ && cache->count < kThreadCacheSize / 2) {
+      FreeBlock* block = shared_head_;
+      shared_head_ = block->next;
+      --shared_count_;
+      block->next = cache->head;
+      cache->head = block;
+      ++cache->count;
+    }
+    if (!cache->head) {
+      CountAllocation(false);
+      return AllocateFresh();
+    }
+  }
+
+  FreeBlock* block = cache->head;
+  cache->head = block->next;
+  --cache->count;
+  CountAllocation(true);
+  return block;
+}
+
+void SlabAllocator::Free(void* block) {
+  live_.fetch_sub(1, std::memory_order_relaxed);
+
+  FreeBlock* freed = static_cast<FreeBlock*>(block);
+  ThreadCache* cache = GetThreadCache();
+  if (!cache) {
+    freed->next = nullptr;
+    PushShared(freed, freed, 1);
+    return;
+  }
+
+  freed->next = cache->head;
+  cache->head = freed;
+  if (++cache->count <= kThreadCacheSize) {
+    return;
+  }
+
+  // Threads that free more than they allocate, such as the main thread unloading chunks the workers generated, pass
+  // the surplus on in batches
+  const size_t kBatch = kThreadCacheSize / 2;
+  FreeBlock* tail = cache->head;
+  for (size_t i = 1; i < kBatch; ++i) {
+    tail = tail->next;
+  }
+  FreeBlock* head = cache->head;
+  cache->head = tail->next;
+  cache->count -= kBatch;
+  tail->next = nullptr;
+  PushShared(head, tail, kBatch);
+}
+
+SlabAllocator::Stats SlabAllocator::GetStats() const {
+  Stats stats;
+  stats.block_size = block_size_;
+  stats.live = live_.load(std::memory_order_relaxed);
+  stats.high_water = high_water_.load(std::memory_order_relaxed);
+  stats.capacity = capacity_.load(std::memory_order_relaxed);
+  stats.allocations = allocations_.load(std::memory_order_relaxed);
+  stats.reuses = reuses_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// mutex_ must be held
+void* SlabAllocator::AllocateFresh() {
+  if (slabs_.empty() || slab_used_ == blocks_per_slab_) {
+    slabs_.push_back(static_cast<char*>(::operator new(block_size_ * blocks_per_slab_)));
+    slab_used_ = 0;
+    capacity_.fetch_add(blocks_per_slab_, std::memory_order_relaxed);
+  }
+  return slabs_.back() + block_size_ * slab_used_++;
+}
+
+void SlabAllocator::PushShared(FreeBlock* head, FreeBlock* tail, size_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tail->next = shared_head_;
+  shared_head_ = head;
+  shared_count_ += count;
+}
+
+void SlabAllocator::CountAllocation(bool reused) {
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  if (reused) {
+    reuses_.fetch_add(1, std::memory_order_relaxed);
+  }
+  size_t live = live_.fetch_add(1, std::memory_order_relaxed) + 1;
+  size_t high_water = high_water_.load(std::memory_order_relaxed);
+  while (live > high_water && !high_water_.compare_exchange_weak(high_water, live, std::memory_order_relaxed)) {
+  }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Hands out blocks of one fixed size, carved from slabs of about kSlabBytes, for the objects made and destroyed as
+// chunks stream in and out - chunks, their block arrays, and the snapshots handed to the workers. Freed blocks go on
+// a free list rather than back to the heap, so once the world has reached its working set streaming allocates nothing.
+// Slabs are never released, and allocators live for the whole program.
+//
+// Every thread keeps a short free list of its own for each allocator, so allocating and freeing take no lock unless
+// that list runs dry or overflows, when half a list's worth of blocks moves to or from the allocator's shared list. A
+// block may be freed on a different thread than allocated it, as when a chunk generated on a worker is unloaded on the
+// main thread.
+class SlabAllocator {
+public:
+  static constexpr size_t kSlabBytes = 64 * 1024;
+  static constexpr size_t kThreadCacheSize = 32;
+  static constexpr size_t kMaxAllocators = 32; // Any more are made without thread caches, so always take the lock
+
+  struct Stats {
+    size_t block_size  = 0;
+    size_t live        = 0; // Allocated and not yet freed
+    size_t high_water  = 0; // Most live at once
+    size_t capacity    = 0; // In every slab allocated so far
+    uint64_t allocations = 0;
+    uint64_t reuses    = 0; // Allocations given a block freed earlier rather than a fresh one
+
+    inline float GetReuseRate() const { return allocations ? (float)reuses / allocations : 0.0f; }
+  };
+
+  // The allocator shared by everything allocating blocks of exactly size bytes, made on first use. Blocks are aligned
+  // for any type
+  static SlabAllocator& ForSize(size_t size);
+
+  // Stats for every allocator made so far, in the order they were made
+  static std::vector<Stats> GetAllStats();
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  void* Allocate();
+  // block must have come from this allocator
+  void Free(void* block);
+
+  Stats GetStats() const;
+
+private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct ThreadCache {
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+  };
+
+  // Hands each thread's free lists back to their allocators when the thread exits
+  struct ThreadCaches {
+    ThreadCache caches[kMaxAllocators];
+    ~ThreadCaches();
+  };
+
+  SlabAllocator(size_t id, size_t size);
+
+  ThreadCache* GetThreadCache();
+  void* AllocateFresh();
+  void PushShared(FreeBlock* head, FreeBlock* tail, size_t count);
+  void CountAllocation(bool reused);
+
+private:
+  static thread_local ThreadCaches thread_caches_;
+
+  const size_t id_;
+  const size_t block_size_;
+  const size_t blocks_per_slab_;
+
+  std::mutex mutex_; // Guards everything below
+  FreeBlock* shared_head_ = nullptr;
+  size_t shared_count_ = 0;
+  std::vector<char*> slabs_;
+  size_t slab_used_ = 0; // Blocks carved from the newest slab
+
+  std::atomic<size_t> live_ = 0;
+  std::atomic<size_t> high_water_ = 0;
+  std::atomic<size_t> capacity_ = 0;
+  std::atomic<uint64_t> allocations_ = 0;
+  std::atomic<uint64_t> reuses_ = 0;
+};
+
+// Standard allocator drawing on SlabAllocator::ForSize, for std::allocate_shared and for containers only ever
+// allocated at a few fixed sizes, such as the arrays of ChunkStorage. Every distinct size gets its own allocator, so
+// it doesn't suit containers grown one element at a time
+template <typename T>
+class SlabStlAllocator {
+public:
+  using value_type = T;
+
+  SlabStlAllocator() = default;
+  template <typename U>
+  SlabStlAllocator(const SlabStlAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Slab blocks are only aligned for fundamental types");
+    return static_cast<T*>(SlabAllocator::ForSize(n * sizeof(T)).Allocate());
+  }
+  void deallocate(T* p, size_t n) { SlabAllocator::ForSize(n * sizeof(T)).Free(p); }
+
+  template <typename U>
+  bool operator==(const SlabStlAllocator<U>&) const { return true; }
+  template <typename U>
+  bool operator!=(const SlabStlAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using SlabVector = std::vector<T, SlabStlAllocator<T>>;
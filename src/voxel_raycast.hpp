@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include "block.hpp"
+#include "chunk_constants.hpp"
+#include "chunk_storage.hpp"
+
+// Finds the first solid block along a ray with Amanatides and Woo's grid traversal, visiting every block the ray passes
+// through in order. The ray walks chunk by chunk, and only walks block by block through chunks holding more than one
+// kind of block - a chunk of a single non-solid block is crossed in one step. Nothing here touches the world, chunks
+// are found through a get_chunk(x, y, z) that returns a pointer to the ChunkStorage of the chunk at those chunk
+// coordinates, or nullptr if it isn't loaded. A ray ends without a hit at the first chunk that isn't loaded, as what
+// it would have hit there is unknown
+namespace VoxelRaycast {
+
+struct Ray {
+  glm::vec3 origin = glm::vec3(0.0f);
+  glm::vec3 dir = glm::vec3(0.0f, 0.0f, -1.0f); // Needn't be normalised
+  float max_dist = 0.0f; // In blocks
+};
+
+struct Hit {
+  bool hit = false;
+  Block block = Block::kUndefined;
+  glm::ivec3 pos = glm::ivec3(0);    // World block coordinates of the block hit
+  glm::ivec3 normal = glm::ivec3(0); // Out of the face the ray entered through, zero if the ray started inside the block
+  float distance = 0.0f;             // From the origin to where the ray entered the block
+};
+
+// Steps through the cells of a grid of cell_size blocks in the order a ray crosses them
+struct Traversal {
+  int cell[3];
+  int step[3];
+  float t_max[3];   // Distance along the ray to the next boundary on each axis
+  float t_delta[3]; // Distance along the ray between boundaries on each axis
+  float t = 0.0f;   // Where the ray entered the current cell
+  int axis = -1;    // Axis of the boundary crossed into the current cell, -1 for the starting cell
+
+  inline void Init(const glm::vec3& origin, const glm::vec3& dir, int cell_size, const int start_cell[3], float start_t) {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+    for (int a = 0; a < 3; ++a) {
+      cell[a] = start_cell[a];
+      if (dir[a] > 0.0f) {
+        step[a] = 1;
+        t_delta[a] = cell_size / dir[a];
+        t_max[a] = ((cell[a] + 1) * cell_size - origin[a]) / dir[a];
+      }
+      else if (dir[a] < 0.0f) {
+        step[a] = -1;
+        t_delta[a] = cell_size / -dir[a];
+        t_max[a] = (cell[a] * cell_size - origin[a]) / dir[a];
+      }
+      else {
+        step[a] = 0;
+        t_delta[a] = kInfinity;
+        t_max[a] = kInfinity;
+      }
+    }
+    t = start_t;
+  }
+
+  inline void Step() {
+    axis = t_max[0] < t_max[1] ? (t_max[0] < t_max[2] ? 0 : 2) : (t_max[1] < t_max[2] ? 1 : 2);
+    cell[axis] += step[axis];
+    t = t_max[axis];
+    t_max[axis] += t_delta[axis];
+  }
+};
+
+inline int FloorDiv(int value, int divisor) {
+  return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+template <typename GetChunk>
+Hit Raycast(const Ray& ray, GetChunk&& get_chunk) {
+  const int kSize = ChunkConstants::kChunkSize;
+  Hit hit;
+  float length = glm::length(ray.dir);
+  if (length == 0.0f) {
+    return hit;
+  }
+  const glm::vec3 dir = ray.dir / length;
+  const glm::vec3& origin = ray.origin;
+
+  int start_block[3], start_chunk[3];
+  for (int a = 0; a < 3; ++a) {
+    start_block[a] = (int)std::floor(origin[a]);
+    start_chunk[a] = FloorDiv(start_block[a], kSize);
+  }
+
+  Traversal chunks;
+  chunks.Init(origin, dir, kSize, start_chunk, 0.0f);
+  for (; chunks.t <= ray.max_dist; chunks.Step()) {
+    const ChunkStorage* storage = get_chunk(chunks.cell[0], chunks.cell[1], chunks.cell[2]);
+    if (!storage) {
+      return hit;
+    }
+    if (storage->GetMode() == ChunkStorage::Mode::kUniform && !BlockProps::IsSolid(storage->Get(0))) {
+      continue;
+    }
+
+    // Start at the block the ray enters the chunk through. Rounding can put the entry point a hair outside the chunk,
+    // so it is clamped in, and the block on the face crossed is set exactly
+    int min[3], block[3];
+    glm::vec3 entry = origin + dir * chunks.t;
+    for (int a = 0; a < 3; ++a) {
+      min[a] = chunks.cell[a] * kSize;
+      if (chunks.axis < 0) {
+        block[a] = start_block[a];
+      }
+      else if (a == chunks.axis) {
+        block[a] = chunks.step[a] > 0 ? min[a] : min[a] + kSize - 1;
+      }
+      else {
+        block[a] = glm::clamp((int)std::floor(entry[a]), min[a], min[a] + kSize - 1);
+      }
+    }
+
+    Traversal blocks;
+    blocks.Init(origin, dir, 1, block, chunks.t);
+    blocks.axis = chunks.axis;
+    while (blocks.t <= ray.max_dist) {
+      int x = blocks.cell[0] - min[0], y = blocks.cell[1] - min[1], z = blocks.cell[2] - min[2];
+      if ((unsigned)x >= (unsigned)kSize || (unsigned)y >= (unsigned)kSize || (unsigned)z >= (unsigned)kSize) {
+        break;
+      }
+      Block b = storage->Get(x, y, z);
+      if (BlockProps::IsSolid(b)) {
+        hit.hit = true;
+        hit.block = b;
+        hit.pos = glm::ivec3(blocks.cell[0], blocks.cell[1], blocks.cell[2]);
+        if (blocks.axis >= 0) {
+          hit.normal[blocks.axis] = -blocks.step[blocks.axis];
+        }
+        hit.distance = blocks.t;
+        return hit;
+      }
+      blocks.Step();
+    }
+  }
+  return hit;
+}
+
+// As Raycast for count rays, writing hits[i] for rays[i]
+template <typename GetChunk>
+void RaycastBatch(const Ray* rays, Hit* hits, size_t count, GetChunk&& get_chunk) {
+  for (size_t i = 0; i < count; ++i) {
+    hits[i] = Raycast(rays[i], get_chunk);
+  }
+}
+
+}
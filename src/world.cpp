@@ -1,34 +1,767 @@
 #include "world.hpp"
 
-#include <simplex.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
-World::World(std::shared_ptr<cl::Context>& context) {
-  simplex_init();
+#include "chunk_lighter.hpp"
+#include "chunk_mesher.hpp"
+#include "graphics_settings.hpp"
+#include "profiler.hpp"
 
-  // TODO: Yeet all this
-  int draw_distance = 8;
+const size_t kCompletedQueueCapacity = 1024;
+// Jobs of each kind in flight at once. A job counts until the main thread takes its result from the completion queue,
+// so within these caps a worker never finds its queue full, and together they leave room in the job system's queue.
+// Generated chunks and LOD nodes share a completion queue
+const size_t kMaxLodBuildsInFlight = 64;
+const size_t kMaxGenerationsInFlight = kCompletedQueueCapacity - kMaxLodBuildsInFlight;
+const size_t kMaxLightBuildsInFlight = kCompletedQueueCapacity;
+const size_t kMaxMeshBuildsInFlight = kCompletedQueueCapacity;
+static_assert(kMaxGenerationsInFlight + kMaxLodBuildsInFlight + kMaxLightBuildsInFlight + kMaxMeshBuildsInFlight
+              <= JobSystem::kQueueCapacity, "World can have more jobs in flight than the job system holds");
+const size_t kSpareMeshCapacity = 32;
+const auto kUpdateBudgetPerFrame = std::chrono::microseconds(4000);
+const char* kSaveDirectory = "saves/world";
 
-  for (int x = -draw_distance; x <= draw_distance; ++x) {
-    for (int y = -2; y <= 0; ++y) {
-      for (int z = -draw_distance; z <= draw_distance; ++z) {
-        chunks_.push_back(std::make_unique<Chunk>(this, x, y, z, context));
+// Offsets to the six chunks sharing a face with a chunk
+const int kFaceNeighbours[6][3] = { { 0, 0, 1 }, { 0, 0, -1 }, { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 } };
+
+// What chunks lit before a neighbour had light took its border to be, see ChunkSnapshot::FillLight
+static const ChunkLight kAssumedSky(ChunkLight::Pack(ChunkLight::kMaxLight, 0));
+static const ChunkLight kAssumedDark(ChunkLight::Pack(0, 0));
+
+// Returns true if a solid block on the border of a touches a solid block on the border of neighbour, which sits at
+// offset from a. Those faces of neighbour were meshed as visible before a was loaded and are now hidden
+static bool BorderOccludes(const Chunk* a, const Chunk* neighbour, const int offset[3]) {
+  const int kLast = ChunkConstants::kChunkSize - 1;
+  int axis = offset[0] != 0 ? 0 : (offset[1] != 0 ? 1 : 2);
+  int a_layer = offset[axis] > 0 ? kLast : 0;
+  int neighbour_layer = kLast - a_layer;
+
+  for (int i = 0; i < ChunkConstants::kChunkSize; ++i) {
+    for (int j = 0; j < ChunkConstants::kChunkSize; ++j) {
+      int a_pos[3], n_pos[3];
+      a_pos[axis] = a_layer;
+      n_pos[axis] = neighbour_layer;
+      a_pos[(axis + 1) % 3] = n_pos[(axis + 1) % 3] = i;
+      a_pos[(axis + 2) % 3] = n_pos[(axis + 2) % 3] = j;
+      if (BlockProps::IsSolid(a->GetBlockAt(a_pos[0], a_pos[1], a_pos[2]))
+       && BlockProps::IsSolid(neighbour->GetBlockAt(n_pos[0], n_pos[1], n_pos[2]))) {
+        return true;
       }
     }
   }
+  return false;
 }
 
-void World::Render(const std::shared_ptr<Camera>& camera) {
-  for (const auto& chunk : chunks_) {
-    chunk->Render();
+World::World(std::shared_ptr<cl::Context>& context)
+    : context_(context), region_store_(kSaveDirectory), generated_chunks_(kCompletedQueueCapacity),
+      lit_chunks_(kCompletedQueueCapacity), built_meshes_(kCompletedQueueCapacity), spare_meshes_(kSpareMeshCapacity) {
+  for (int level = 1; level <= ChunkLod::kMaxLevels; ++level) {
+    lod_levels_[level - 1] = std::make_unique<LodLevel>(ChunkLod::ScaleOf(level));
   }
 }
 
-Chunk* World::GetChunkAt(int chunk_x, int chunk_y, int chunk_z) {
-  for (size_t i = 0; i < chunks_.size(); ++i) {
-    Chunk* chunk = chunks_[i].get();
-    if (chunk_x == chunk->GetX() && chunk_y == chunk->GetY() && chunk_z == chunk->GetZ()) {
-      return chunk;
+World::~World() {
+  chunks_.ForEach([&](const std::unique_ptr<Chunk>& chunk){
+    if (chunk->IsModified()) {
+      SaveChunk(*chunk);
+    }
+  });
+
+  // Workers blocked on a full completion queue would otherwise never let the job system shut down
+  shutting_down_.store(true, std::memory_order_release);
+}
+
+// The in-flight caps leave room in every completion queue, so this only waits if they are set larger than the queues
+template <typename T>
+void World::PushCompleted(MpmcQueue<T>& queue, T&& value) {
+  while (!queue.TryPush(std::move(value))) {
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+}
+
+void World::ScheduleChunkGeneration(int chunk_x, int chunk_y, int chunk_z) {
+  pending_generation_.Insert(chunk_x, chunk_y, chunk_z, true);
+  ++generations_in_flight_;
+
+  job_system_.Schedule([this, chunk_x, chunk_y, chunk_z](){
+    PROFILE_SCOPE("GenerateChunk");
+    GeneratedChunk generated;
+    generated.chunk_x = chunk_x;
+    generated.chunk_y = chunk_y;
+    generated.chunk_z = chunk_z;
+    generated.blocks = Chunk::GenerateBlocks(this, chunk_x, chunk_y, chunk_z);
+    PushCompleted(generated_chunks_, std::move(generated));
+  });
+}
+
+void World::ScheduleMeshBuild(Chunk* chunk, int level) {
+  // Nothing to draw, so no need for the workers. Taking a version still discards any older build in flight
+  if (!HasVisibleFaces(chunk, level)) {
+    ChunkMeshPool& mesh_pool = level == 0 ? mesh_pool_ : lod_levels_[level - 1]->mesh_pool;
+    mesh_pool.Remove(chunk->GetX(), chunk->GetY(), chunk->GetZ());
+    chunk->SetUploadedMeshVersion(chunk->NextMeshVersion());
+    chunk->SetConnectivity(BlockProps::IsSolid(chunk->GetBlocks().Get(0)) ? ChunkConnectivity::None()
+                                                                          : ChunkConnectivity::All());
+    return;
+  }
+
+  // The workers are full up, so the build waits in the remesh queue for a slot. Chunks not yet meshed for the first
+  // time wait there too, as nothing else would come back for them
+  if (mesh_builds_in_flight_ >= kMaxMeshBuildsInFlight) {
+    if (!chunk->IsMeshDirty()) {
+      chunk->SetMeshDirty(true);
+      GetRemeshQueue(level).PushBack(glm::ivec3(chunk->GetX(), chunk->GetY(), chunk->GetZ()));
+    }
+    return;
+  }
+  // This build sees every edit so far, so a remesh already queued has nothing left to do
+  chunk->SetMeshDirty(false);
+  ++mesh_builds_in_flight_;
+
+  auto snapshot = std::allocate_shared<ChunkSnapshot>(SlabStlAllocator<ChunkSnapshot>());
+  CreateSnapshot(chunk->GetX(), chunk->GetY(), chunk->GetZ(), *snapshot, level);
+
+  int chunk_x = chunk->GetX(), chunk_y = chunk->GetY(), chunk_z = chunk->GetZ();
+  uint32_t instance_id = chunk->GetInstanceId();
+  uint32_t version = chunk->NextMeshVersion();
+  MeshingMode mode = GraphicsSettings::meshing_mode;
+
+  job_system_.Schedule([this, snapshot, level, chunk_x, chunk_y, chunk_z, instance_id, version, mode](){
+    PROFILE_SCOPE("BuildMesh");
+    BuiltMesh built;
+    built.level = level;
+    built.chunk_x = chunk_x;
+    built.chunk_y = chunk_y;
+    built.chunk_z = chunk_z;
+    built.instance_id = instance_id;
+    built.version = version;
+    // Each worker keeps its own arena, and the exact-size copy handed to the main thread goes into a mesh it handed
+    // back, so once the buffers have grown to fit, meshing allocates nothing
+    thread_local ChunkMeshArena arena;
+    ChunkMesher::BuildMesh(*snapshot, mode, arena);
+    spare_meshes_.TryPop(built.mesh);
+    arena.CopyTo(built.mesh);
+    if (level == 0) {
+      built.connectivity = ChunkConnectivity::Compute(*snapshot);
+    }
+    PushCompleted(built_meshes_, std::move(built));
+  });
+}
+
+void World::ScheduleLightBuild(Chunk* chunk) {
+  // No light gets into a chunk of opaque blocks, so it is dark without a trip to the workers
+  const ChunkStorage& blocks = chunk->GetBlocks();
+  if (blocks.GetMode() == ChunkStorage::Mode::kUniform && !BlockProps::IsTransparent(blocks.Get(0))) {
+    LitChunk lit;
+    lit.chunk_x = chunk->GetX();
+    lit.chunk_y = chunk->GetY();
+    lit.chunk_z = chunk->GetZ();
+    lit.instance_id = chunk->GetInstanceId();
+    lit.version = chunk->NextLightVersion();
+    AddLitChunk(lit);
+    return;
+  }
+
+  // As for meshes, the build waits in the relight queue while the workers are full up
+  if (light_builds_in_flight_ >= kMaxLightBuildsInFlight) {
+    if (!chunk->IsLightDirty()) {
+      chunk->SetLightDirty(true);
+      relight_queue_.PushBack(glm::ivec3(chunk->GetX(), chunk->GetY(), chunk->GetZ()));
     }
+    return;
+  }
+  chunk->SetLightDirty(false);
+  ++light_builds_in_flight_;
+
+  auto snapshot = std::allocate_shared<ChunkSnapshot>(SlabStlAllocator<ChunkSnapshot>());
+  CreateSnapshot(chunk->GetX(), chunk->GetY(), chunk->GetZ(), *snapshot);
+
+  int chunk_x = chunk->GetX(), chunk_y = chunk->GetY(), chunk_z = chunk->GetZ();
+  uint32_t instance_id = chunk->GetInstanceId();
+  uint32_t version = chunk->NextLightVersion();
+
+  job_system_.Schedule([this, snapshot, chunk_x, chunk_y, chunk_z, instance_id, version](){
+    PROFILE_SCOPE("ComputeLight");
+    LitChunk lit;
+    lit.chunk_x = chunk_x;
+    lit.chunk_y = chunk_y;
+    lit.chunk_z = chunk_z;
+    lit.instance_id = instance_id;
+    lit.version = version;
+    ChunkLighter::ComputeLight(*snapshot, lit.light);
+    PushCompleted(lit_chunks_, std::move(lit));
+  });
+}
+
+// False for a chunk of air, or a solid chunk with a solid chunk against every face, neither of which has any faces
+// exposed. Only uniform chunks are checked, as they can be told apart without looking at their blocks
+bool World::HasVisibleFaces(const Chunk* chunk, int level) {
+  auto is_uniform = [](const Chunk* c, bool solid){
+    const ChunkStorage& blocks = c->GetBlocks();
+    return blocks.GetMode() == ChunkStorage::Mode::kUniform && BlockProps::IsSolid(blocks.Get(0)) == solid;
+  };
+
+  if (is_uniform(chunk, false)) {
+    return false;
+  }
+  if (!is_uniform(chunk, true)) {
+    return true;
+  }
+  for (const auto& offset : kFaceNeighbours) {
+    const Chunk* neighbour = GetNodeAt(level, chunk->GetX() + offset[0], chunk->GetY() + offset[1], chunk->GetZ() + offset[2]);
+    if (!neighbour || !is_uniform(neighbour, true)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// A chunk is first meshed once it is lit and every neighbour that is on its way has arrived and been lit, so it is
+// meshed once with full knowledge of its borders rather than once per neighbour
+bool World::IsReadyToMesh(const Chunk* chunk) {
+  if (!chunk->HasLight()) {
+    return false;
+  }
+  for (const auto& offset : kFaceNeighbours) {
+    int x = chunk->GetX() + offset[0], y = chunk->GetY() + offset[1], z = chunk->GetZ() + offset[2];
+    const Chunk* neighbour = GetChunkAt(x, y, z);
+    if (pending_generation_.Find(x, y, z) || (neighbour && !neighbour->HasLight())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Neighbours already waiting in the remesh queue for room on the workers are left there
+void World::MeshWaitingNeighbours(int chunk_x, int chunk_y, int chunk_z) {
+  for (const auto& offset : kFaceNeighbours) {
+    Chunk* neighbour = GetChunkAt(chunk_x + offset[0], chunk_y + offset[1], chunk_z + offset[2]);
+    if (neighbour && !neighbour->IsMeshRequested() && !neighbour->IsMeshDirty() && IsReadyToMesh(neighbour)) {
+      ScheduleMeshBuild(neighbour);
+    }
+  }
+}
+
+void World::AddGeneratedChunk(GeneratedChunk& generated) {
+  int chunk_x = generated.chunk_x, chunk_y = generated.chunk_y, chunk_z = generated.chunk_z;
+  pending_generation_.Erase(chunk_x, chunk_y, chunk_z);
+  --generations_in_flight_;
+
+  // The camera has moved away since this chunk was requested
+  if (!streamer_.ShouldKeep(chunk_x, chunk_y, chunk_z)) {
+    MeshWaitingNeighbours(chunk_x, chunk_y, chunk_z);
+    return;
   }
-  return nullptr;
-}
\ No newline at end of file
+
+  Chunk* chunk = chunks_.Insert(chunk_x, chunk_y, chunk_z,
+    std::make_unique<Chunk>(chunk_x, chunk_y, chunk_z, std::move(generated.blocks))).get();
+  culler_.Add(chunk);
+
+  // The chunk and its unmeshed neighbours are meshed once it has been lit, see AddLitChunk. Only the meshed
+  // neighbours whose border faces are now hidden need rebuilding straight away
+  ScheduleLightBuild(chunk);
+  for (const auto& offset : kFaceNeighbours) {
+    Chunk* neighbour = GetChunkAt(chunk_x + offset[0], chunk_y + offset[1], chunk_z + offset[2]);
+    if (neighbour && neighbour->IsMeshRequested() && BorderOccludes(chunk, neighbour, offset)) {
+      ScheduleMeshBuild(neighbour);
+    }
+  }
+}
+
+void World::AddLitChunk(LitChunk& lit) {
+  int chunk_x = lit.chunk_x, chunk_y = lit.chunk_y, chunk_z = lit.chunk_z;
+  Chunk* chunk = GetChunkAt(chunk_x, chunk_y, chunk_z);
+  // Unloaded since, or relit again with a newer result on its way
+  if (!chunk || chunk->GetInstanceId() != lit.instance_id || lit.version != chunk->GetRequestedLightVersion()) {
+    return;
+  }
+
+  // Light only crosses into a neighbour through the border facing it. Neighbours lit before this chunk had light took
+  // it to be open sky if it is on their sky side and dark otherwise
+  bool border_changed[3][2];
+  for (int axis = 0; axis < 3; ++axis) {
+    for (int side = 0; side < 2; ++side) {
+      const ChunkLight& before = chunk->HasLight() ? chunk->GetLight()
+                                                   : (axis == 1 && side == 1 ? kAssumedSky : kAssumedDark);
+      border_changed[axis][side] = !lit.light.BorderEquals(before, axis, side);
+    }
+  }
+
+  bool had_light = chunk->HasLight();
+  bool changed = !had_light || !lit.light.Equals(chunk->GetLight());
+  chunk->SetLight(std::move(lit.light));
+  if (!changed) {
+    return;
+  }
+
+  for (int axis = 0; axis < 3; ++axis) {
+    for (int side = 0; side < 2; ++side) {
+      if (border_changed[axis][side]) {
+        int pos[3] = { chunk_x, chunk_y, chunk_z };
+        pos[axis] += side == 0 ? -1 : 1;
+        MarkLightDirty(pos[0], pos[1], pos[2]);
+      }
+    }
+  }
+
+  // Meshes are lit from one block past their chunk, so neighbours across a changed border are remeshed too, including
+  // those meeting it only along an edge or at a corner
+  for (int dz = -1; dz <= 1; ++dz) {
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        const int d[3] = { dx, dy, dz };
+        bool touches_change = dx == 0 && dy == 0 && dz == 0;
+        for (int axis = 0; axis < 3; ++axis) {
+          touches_change |= d[axis] != 0 && border_changed[axis][d[axis] < 0 ? 0 : 1];
+        }
+        if (touches_change) {
+          MarkMeshDirty(chunk_x + dx, chunk_y + dy, chunk_z + dz);
+        }
+      }
+    }
+  }
+
+  if (!chunk->IsMeshRequested() && IsReadyToMesh(chunk)) {
+    ScheduleMeshBuild(chunk);
+  }
+  MeshWaitingNeighbours(chunk_x, chunk_y, chunk_z);
+}
+
+void World::UnloadChunk(int chunk_x, int chunk_y, int chunk_z) {
+  auto found = chunks_.Find(chunk_x, chunk_y, chunk_z);
+  if (!found) {
+    return;
+  }
+  std::unique_ptr<Chunk> chunk = std::move(*found);
+  chunks_.Erase(chunk_x, chunk_y, chunk_z);
+  culler_.Remove(chunk.get());
+  mesh_pool_.Remove(chunk_x, chunk_y, chunk_z);
+  if (chunk->IsModified()) {
+    SaveChunk(*chunk);
+  }
+
+  // Neighbours that had faces hidden against this chunk need them back
+  for (const auto& offset : kFaceNeighbours) {
+    const int reverse[3] = { -offset[0], -offset[1], -offset[2] };
+    Chunk* neighbour = GetChunkAt(chunk_x + offset[0], chunk_y + offset[1], chunk_z + offset[2]);
+    if (neighbour && neighbour->IsMeshRequested() && BorderOccludes(neighbour, chunk.get(), reverse)) {
+      ScheduleMeshBuild(neighbour);
+    }
+  }
+}
+
+void World::StreamChunks(const std::shared_ptr<Camera>& camera) {
+  PROFILE_SCOPE("StreamChunks");
+  bool centre_changed = streamer_.SetCentre(camera->GetEyePosition(), camera->GetForward());
+  if (centre_changed) {
+    unload_queue_.clear();
+    chunks_.ForEach([&](const std::unique_ptr<Chunk>& chunk){
+      if (!streamer_.ShouldKeep(chunk->GetX(), chunk->GetY(), chunk->GetZ())) {
+        unload_queue_.push_back(glm::ivec3(chunk->GetX(), chunk->GetY(), chunk->GetZ()));
+      }
+    });
+  }
+
+  for (int i = 0; i < GraphicsSettings::max_chunk_unloads_per_frame && !unload_queue_.empty(); ++i) {
+    glm::ivec3 coord = unload_queue_.back();
+    unload_queue_.pop_back();
+    // The camera may have come back since the unload was queued
+    if (!streamer_.ShouldKeep(coord.x, coord.y, coord.z)) {
+      UnloadChunk(coord.x, coord.y, coord.z);
+    }
+  }
+
+  size_t max_loads = std::min((size_t)std::max(GraphicsSettings::max_chunk_loads_per_frame, 0),
+                              kMaxGenerationsInFlight - generations_in_flight_);
+  streamer_.StreamIn(max_loads, [&](int chunk_x, int chunk_y, int chunk_z){
+    if (GetChunkAt(chunk_x, chunk_y, chunk_z) || pending_generation_.Find(chunk_x, chunk_y, chunk_z)) {
+      return false;
+    }
+    ScheduleChunkGeneration(chunk_x, chunk_y, chunk_z);
+    return true;
+  });
+
+  StreamLod(centre_changed);
+}
+
+void World::StreamLod(bool centre_changed) {
+  if (centre_changed) {
+    for (int level = 1; level <= ChunkLod::kMaxLevels; ++level) {
+      UnloadLodNodes(level);
+    }
+  }
+
+  // Nodes take far longer to build than chunks, so only a few are queued at once to leave the workers free for the
+  // chunks near the camera
+  size_t max_builds = std::min((size_t)std::max(GraphicsSettings::max_lod_builds_in_flight, 0), kMaxLodBuildsInFlight);
+  if (lod_builds_in_flight_ >= max_builds) {
+    return;
+  }
+  streamer_.StreamLodIn(max_builds - lod_builds_in_flight_, [&](int level, int node_x, int node_y, int node_z){
+    LodLevel& lod = *lod_levels_[level - 1];
+    if (lod.nodes.Find(node_x, node_y, node_z) || lod.pending.Find(node_x, node_y, node_z)) {
+      return false;
+    }
+    ScheduleLodBuild(level, node_x, node_y, node_z);
+    return true;
+  });
+}
+
+void World::ScheduleLodBuild(int level, int node_x, int node_y, int node_z) {
+  lod_levels_[level - 1]->pending.Insert(node_x, node_y, node_z, true);
+  ++lod_builds_in_flight_;
+
+  job_system_.Schedule([this, level, node_x, node_y, node_z](){
+    PROFILE_SCOPE("BuildLodNode");
+    GeneratedChunk generated;
+    generated.level = level;
+    generated.chunk_x = node_x;
+    generated.chunk_y = node_y;
+    generated.chunk_z = node_z;
+    generated.blocks = ChunkLod::BuildNode(this, level, node_x, node_y, node_z);
+    PushCompleted(generated_chunks_, std::move(generated));
+  });
+}
+
+void World::AddLodNode(GeneratedChunk& generated) {
+  int level = generated.level;
+  int node_x = generated.chunk_x, node_y = generated.chunk_y, node_z = generated.chunk_z;
+  LodLevel& lod = *lod_levels_[level - 1];
+  lod.pending.Erase(node_x, node_y, node_z);
+  --lod_builds_in_flight_;
+
+  if (!streamer_.InLodRing(level, node_x, node_y, node_z, GraphicsSettings::unload_margin)) {
+    return;
+  }
+
+  Chunk* node = lod.nodes.Insert(node_x, node_y, node_z,
+    std::make_unique<Chunk>(node_x, node_y, node_z, std::move(generated.blocks))).get();
+  lod.culler.Add(node);
+
+  // Nodes are meshed straight away rather than waiting for their neighbours, which are built far more slowly than
+  // chunks. Neighbours already meshed rebuild if the new node hides some of their faces
+  ScheduleMeshBuild(node, level);
+  for (const auto& offset : kFaceNeighbours) {
+    Chunk* neighbour = GetNodeAt(level, node_x + offset[0], node_y + offset[1], node_z + offset[2]);
+    if (neighbour && BorderOccludes(node, neighbour, offset)) {
+      ScheduleMeshBuild(neighbour, level);
+    }
+  }
+}
+
+void World::UnloadLodNodes(int level) {
+  LodLevel& lod = *lod_levels_[level - 1];
+
+  lod.nodes.ForEach([&](std::unique_ptr<Chunk>& node){
+    if (!streamer_.InLodRing(level, node->GetX(), node->GetY(), node->GetZ(), GraphicsSettings::unload_margin)) {
+      unloaded_nodes_.push_back(std::move(node));
+    }
+  });
+  for (const std::unique_ptr<Chunk>& node : unloaded_nodes_) {
+    lod.nodes.Erase(node->GetX(), node->GetY(), node->GetZ());
+    lod.culler.Remove(node.get());
+    lod.mesh_pool.Remove(node->GetX(), node->GetY(), node->GetZ());
+  }
+
+  // Whole rings move at once, so neighbours are only rebuilt after every node going has gone, and only once each
+  remeshed_nodes_.Clear();
+  for (const std::unique_ptr<Chunk>& node : unloaded_nodes_) {
+    for (const auto& offset : kFaceNeighbours) {
+      const int reverse[3] = { -offset[0], -offset[1], -offset[2] };
+      int x = node->GetX() + offset[0], y = node->GetY() + offset[1], z = node->GetZ() + offset[2];
+      Chunk* neighbour = GetNodeAt(level, x, y, z);
+      if (neighbour && !remeshed_nodes_.Find(x, y, z) && BorderOccludes(neighbour, node.get(), reverse)) {
+        remeshed_nodes_.Insert(x, y, z, true);
+        ScheduleMeshBuild(neighbour, level);
+      }
+    }
+  }
+  unloaded_nodes_.clear();
+}
+
+void World::SaveChunk(const Chunk& chunk) {
+  Block blocks[ChunkStorage::kNumBlocks];
+  chunk.GetBlocks().CopyTo(blocks);
+  region_store_.StoreChunk(chunk.GetX(), chunk.GetY(), chunk.GetZ(), blocks);
+}
+
+// Floor division, so that block -1 lands in chunk -1 rather than chunk 0
+static inline int ChunkOf(int block_coord) {
+  return block_coord >= 0 ? block_coord / ChunkConstants::kChunkSize
+                          : (block_coord - ChunkConstants::kChunkSize + 1) / ChunkConstants::kChunkSize;
+}
+
+Block World::GetBlockAt(int x, int y, int z) {
+  int chunk_x = ChunkOf(x), chunk_y = ChunkOf(y), chunk_z = ChunkOf(z);
+  const Chunk* chunk = GetChunkAt(chunk_x, chunk_y, chunk_z);
+  if (!chunk) {
+    return Block::kUndefined;
+  }
+  return chunk->GetBlockAt(x - chunk_x * ChunkConstants::kChunkSize, y - chunk_y * ChunkConstants::kChunkSize,
+    z - chunk_z * ChunkConstants::kChunkSize);
+}
+
+bool World::SetBlockAt(int x, int y, int z, Block b) {
+  int chunk_x = ChunkOf(x), chunk_y = ChunkOf(y), chunk_z = ChunkOf(z);
+  Chunk* chunk = GetChunkAt(chunk_x, chunk_y, chunk_z);
+  if (!chunk) {
+    return false;
+  }
+
+  int local[3] = { x - chunk_x * ChunkConstants::kChunkSize, y - chunk_y * ChunkConstants::kChunkSize, z - chunk_z * ChunkConstants::kChunkSize };
+  if (chunk->GetBlockAt(local[0], local[1], local[2]) == b) {
+    return true;
+  }
+  chunk->SetBlockAt(local[0], local[1], local[2], b);
+  MarkLightDirty(chunk_x, chunk_y, chunk_z);
+
+  // A block on the border is also in the snapshots of the chunks across that border, including diagonally across an
+  // edge or corner
+  int first[3], last[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    first[axis] = local[axis] == 0 ? -1 : 0;
+    last[axis] = local[axis] == ChunkConstants::kChunkSize - 1 ? 1 : 0;
+  }
+  for (int dz = first[2]; dz <= last[2]; ++dz) {
+    for (int dy = first[1]; dy <= last[1]; ++dy) {
+      for (int dx = first[0]; dx <= last[0]; ++dx) {
+        MarkMeshDirty(chunk_x + dx, chunk_y + dy, chunk_z + dz);
+      }
+    }
+  }
+  return true;
+}
+
+VoxelRaycast::Hit World::Raycast(const glm::vec3& origin, const glm::vec3& dir, float max_dist) {
+  return VoxelRaycast::Raycast(VoxelRaycast::Ray { origin, dir, max_dist }, [this](int x, int y, int z){
+    const Chunk* chunk = GetChunkAt(x, y, z);
+    return chunk ? &chunk->GetBlocks() : nullptr;
+  });
+}
+
+void World::RaycastBatch(const std::vector<VoxelRaycast::Ray>& rays, std::vector<VoxelRaycast::Hit>& hits) {
+  hits.resize(rays.size());
+  VoxelRaycast::RaycastBatch(rays.data(), hits.data(), rays.size(), [this](int x, int y, int z){
+    const Chunk* chunk = GetChunkAt(x, y, z);
+    return chunk ? &chunk->GetBlocks() : nullptr;
+  });
+}
+
+void World::MarkMeshDirty(int chunk_x, int chunk_y, int chunk_z) {
+  Chunk* chunk = GetChunkAt(chunk_x, chunk_y, chunk_z);
+  // Chunks not yet meshed for the first time will see the edit when they are
+  if (!chunk || chunk->IsMeshDirty() || !chunk->IsMeshRequested()) {
+    return;
+  }
+  chunk->SetMeshDirty(true);
+  remesh_queue_.PushBack(glm::ivec3(chunk_x, chunk_y, chunk_z));
+}
+
+RingQueue<glm::ivec3>& World::GetRemeshQueue(int level) {
+  return level == 0 ? remesh_queue_ : lod_levels_[level - 1]->remesh_queue;
+}
+
+// Chunks go first, then nodes nearest the camera first. Stops once the workers are full up rather than taking builds
+// off the queue only to put them back
+void World::RemeshDirtyChunks() {
+  int remeshes = 0;
+  for (int level = 0; level <= ChunkLod::kMaxLevels; ++level) {
+    RingQueue<glm::ivec3>& queue = GetRemeshQueue(level);
+    for (; remeshes < GraphicsSettings::max_remeshes_per_frame && !queue.Empty()
+           && mesh_builds_in_flight_ < kMaxMeshBuildsInFlight; ++remeshes) {
+      glm::ivec3 coord = queue.Front();
+      queue.PopFront();
+      // May have been unloaded since it was queued
+      Chunk* chunk = GetNodeAt(level, coord.x, coord.y, coord.z);
+      if (chunk && chunk->IsMeshDirty()) {
+        chunk->SetMeshDirty(false);
+        ScheduleMeshBuild(chunk, level);
+      }
+    }
+  }
+}
+
+void World::MarkLightDirty(int chunk_x, int chunk_y, int chunk_z) {
+  Chunk* chunk = GetChunkAt(chunk_x, chunk_y, chunk_z);
+  if (!chunk || chunk->IsLightDirty()) {
+    return;
+  }
+  chunk->SetLightDirty(true);
+  relight_queue_.PushBack(glm::ivec3(chunk_x, chunk_y, chunk_z));
+}
+
+void World::RelightDirtyChunks() {
+  for (int i = 0; i < GraphicsSettings::max_relights_per_frame && !relight_queue_.Empty()
+                  && light_builds_in_flight_ < kMaxLightBuildsInFlight; ++i) {
+    glm::ivec3 coord = relight_queue_.Front();
+    relight_queue_.PopFront();
+    // May have been unloaded since it was queued
+    Chunk* chunk = GetChunkAt(coord.x, coord.y, coord.z);
+    if (chunk && chunk->IsLightDirty()) {
+      chunk->SetLightDirty(false);
+      ScheduleLightBuild(chunk);
+    }
+  }
+}
+
+void World::Update(const std::shared_ptr<Camera>& camera) {
+  PROFILE_SCOPE("Update");
+  auto start_time = std::chrono::steady_clock::now();
+  auto budget_spent = [&](){ return std::chrono::steady_clock::now() - start_time > kUpdateBudgetPerFrame; };
+
+  StreamChunks(camera);
+  RelightDirtyChunks();
+  RemeshDirtyChunks();
+
+  BuiltMesh built;
+  while (built_meshes_.TryPop(built)) {
+    PROFILE_SCOPE("StoreMesh");
+    --mesh_builds_in_flight_;
+    Chunk* chunk = GetNodeAt(built.level, built.chunk_x, built.chunk_y, built.chunk_z);
+    if (chunk && chunk->GetInstanceId() == built.instance_id && built.version > chunk->GetUploadedMeshVersion()) {
+      ChunkMeshPool& mesh_pool = built.level == 0 ? mesh_pool_ : lod_levels_[built.level - 1]->mesh_pool;
+      mesh_pool.Store(built.chunk_x, built.chunk_y, built.chunk_z, built.mesh);
+      chunk->SetUploadedMeshVersion(built.version);
+      chunk->SetConnectivity(built.connectivity);
+    }
+    // Dropped if the workers already have enough spares
+    spare_meshes_.TryPush(std::move(built.mesh));
+    if (budget_spent()) {
+      return;
+    }
+  }
+
+  LitChunk lit;
+  while (lit_chunks_.TryPop(lit)) {
+    PROFILE_SCOPE("AddLitChunk");
+    --light_builds_in_flight_;
+    AddLitChunk(lit);
+    if (budget_spent()) {
+      return;
+    }
+  }
+
+  GeneratedChunk generated;
+  while (generated_chunks_.TryPop(generated)) {
+    PROFILE_SCOPE("AddGeneratedChunk");
+    if (generated.level == 0) {
+      AddGeneratedChunk(generated);
+    }
+    else {
+      AddLodNode(generated);
+    }
+    if (budget_spent()) {
+      return;
+    }
+  }
+}
+
+void World::CreateSnapshot(int chunk_x, int chunk_y, int chunk_z, ChunkSnapshot& snapshot, int level) {
+  // Nodes only see neighbours of their own level, so the edges of each LOD ring are closed off with faces
+  snapshot.Fill(chunk_x, chunk_y, chunk_z, [this, level](int x, int y, int z) -> const ChunkStorage* {
+    const Chunk* chunk = GetNodeAt(level, x, y, z);
+    return chunk ? &chunk->GetBlocks() : nullptr;
+  });
+
+  if (level > 0) {
+    std::memset(snapshot.light, ChunkLight::Pack(ChunkLight::kMaxLight, 0), sizeof(snapshot.light));
+    return;
+  }
+  snapshot.FillLight(chunk_x, chunk_y, chunk_z, [this](int x, int y, int z) -> const ChunkLight* {
+    const Chunk* chunk = GetChunkAt(x, y, z);
+    return chunk && chunk->HasLight() ? &chunk->GetLight() : nullptr;
+  });
+}
+
+void World::Render(const std::shared_ptr<Camera>& camera, std::shared_ptr<cl::Shader>& shader) {
+  PROFILE_SCOPE("Render");
+  render_stats_ = RenderStats();
+  render_stats_.chunks_loaded = chunks_.Size();
+
+  {
+    PROFILE_SCOPE("Upload");
+    mesh_pool_.Upload(context_);
+    for (const auto& lod : lod_levels_) {
+      lod->mesh_pool.Upload(context_);
+    }
+  }
+  ChunkMeshPool::Stats pool_stats = mesh_pool_.GetStats();
+  render_stats_.page_uploads = pool_stats.page_uploads;
+  render_stats_.vertices_resident = pool_stats.vertices;
+  for (const auto& lod : lod_levels_) {
+    pool_stats = lod->mesh_pool.GetStats();
+    render_stats_.page_uploads += pool_stats.page_uploads;
+    render_stats_.vertices_resident += pool_stats.vertices;
+  }
+
+  Frustum frustum = Frustum::FromViewProjection(camera->GetViewProjection());
+  glm::vec3 eye = camera->GetEyePosition();
+  DrawLevel(0, frustum, eye, shader, render_stats_.chunks_visible);
+  for (int level = 1; level <= streamer_.GetLodLevels(); ++level) {
+    DrawLevel(level, frustum, eye, shader, render_stats_.lod_nodes_visible);
+  }
+}
+
+void World::DrawLevel(int level, const Frustum& frustum, const glm::vec3& eye, std::shared_ptr<cl::Shader>& shader,
+                      size_t& num_visible) {
+  ChunkCuller& culler = level == 0 ? culler_ : lod_levels_[level - 1]->culler;
+  ChunkMeshPool& mesh_pool = level == 0 ? mesh_pool_ : lod_levels_[level - 1]->mesh_pool;
+
+  if (GraphicsSettings::frustum_culling) {
+    PROFILE_SCOPE("Cull");
+    auto start_time = std::chrono::steady_clock::now();
+    culler.Cull(frustum, GraphicsSettings::hierarchical_culling, visible_chunks_);
+    render_stats_.cull_time_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+    render_stats_.groups_rejected += culler.GetStats().groups_rejected;
+  }
+  else {
+    visible_chunks_.clear();
+    const ChunkMap<std::unique_ptr<Chunk>>& chunks = level == 0 ? chunks_ : lod_levels_[level - 1]->nodes;
+    chunks.ForEach([&](const std::unique_ptr<Chunk>& chunk){ visible_chunks_.push_back(chunk.get()); });
+  }
+
+  // LOD nodes are lit and meshed as if under open sky, so only full detail chunks know where the walls are. Chunks
+  // past the edge of the ring are still searched through, as the view can pass through them to chunks inside it
+  if (level == 0 && GraphicsSettings::occlusion_culling) {
+    PROFILE_SCOPE("OcclusionCull");
+    auto start_time = std::chrono::steady_clock::now();
+    const int kSize = ChunkConstants::kChunkSize;
+    occlusion_culler_.Cull((int)std::floor(eye.x / kSize), (int)std::floor(eye.y / kSize), (int)std::floor(eye.z / kSize),
+                           chunks_, visible_chunks_);
+    render_stats_.cull_time_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+    render_stats_.chunks_occluded += occlusion_culler_.GetStats().chunks_occluded;
+  }
+
+  // Chunks and nodes kept loaded past the edge of their ring would overlap the level drawn there. Pages are drawn
+  // whole, but the mesh pool masks out every chunk not in visible_chunks_, so this holds at draw time
+  visible_chunks_.erase(std::remove_if(visible_chunks_.begin(), visible_chunks_.end(), [&](const Chunk* chunk){
+    return !streamer_.InLodRing(level, chunk->GetX(), chunk->GetY(), chunk->GetZ());
+  }), visible_chunks_.end());
+  num_visible += visible_chunks_.size();
+
+  PROFILE_SCOPE("Submit");
+  mesh_pool.BuildCommands(visible_chunks_, draw_commands_);
+  render_stats_.draw_commands += draw_commands_.GetCommands().size();
+  render_stats_.draw_calls += mesh_pool.Submit(draw_commands_, shader);
+  render_stats_.vertices_submitted += mesh_pool.GetVerticesSubmitted();
+}
+
+Chunk* World::GetNodeAt(int level, int chunk_x, int chunk_y, int chunk_z) {
+  if (level == 0) {
+    return GetChunkAt(chunk_x, chunk_y, chunk_z);
+  }
+  auto node = lod_levels_[level - 1]->nodes.Find(chunk_x, chunk_y, chunk_z);
+  return node ? node->get() : nullptr;
+}
+
+Chunk* World::GetChunkAt(int chunk_x, int chunk_y, int chunk_z) {
+  auto chunk = chunks_.Find(chunk_x, chunk_y, chunk_z);
+  return chunk ? chunk->get() : nullptr;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -7,14 +8,162 @@
 
 #include "camera.hpp"
 #include "chunk.hpp"
+#include "chunk_culler.hpp"
+#include "chunk_lod.hpp"
+#include "chunk_map.hpp"
+#include "chunk_mesh_pool.hpp"
+#include "chunk_occlusion_culler.hpp"
+#include "chunk_snapshot.hpp"
+#include "chunk_streamer.hpp"
+#include "job_system.hpp"
+#include "mpmc_queue.hpp"
+#include "region_store.hpp"
+#include "ring_queue.hpp"
+#include "voxel_raycast.hpp"
 
 class World {
 public:
+  struct RenderStats {
+    size_t chunks_loaded   = 0;
+    size_t chunks_visible  = 0;
+    size_t lod_nodes_visible = 0;
+    size_t groups_rejected = 0;
+    size_t chunks_occluded = 0; // In the frustum but walled off from the camera, see ChunkOcclusionCuller
+    size_t draw_commands   = 0; // Merged index ranges drawn, one or more per page drawn
+    size_t draw_calls      = 0;
+    size_t page_uploads    = 0;
+    size_t vertices_resident = 0; // Held by every mesh pool
+    size_t vertices_submitted = 0; // Shaded this frame, including chunks in drawn pages that were culled
+    float  cull_time_ms    = 0.0f;
+  };
+
   World(std::shared_ptr<cl::Context>& context);
+  ~World();
+
+  // Streams chunks in and out around the camera, then takes chunks, light and meshes finished by the worker threads,
+  // adding them to the world and uploading meshes until the per-frame time budget is spent. Must be called on the
+  // thread that owns the context, after the camera has been uploaded
+  void Update(const std::shared_ptr<Camera>& camera);
 
-  void Render(const std::shared_ptr<Camera>& camera);
+  void Render(const std::shared_ptr<Camera>& camera, std::shared_ptr<cl::Shader>& shader);
+  inline const RenderStats& GetRenderStats() const { return render_stats_; }
   Chunk* GetChunkAt(int chunk_x, int chunk_y, int chunk_z);
 
+  // Block coordinates are in world space. Returns kUndefined if the chunk holding the block isn't loaded
+  Block GetBlockAt(int x, int y, int z);
+
+  // Changes a block and marks its chunk for relighting and remeshing, along with any neighbouring chunks that can see
+  // the block. The chunks are relit and remeshed on the workers during later calls to Update, a few per frame, so any
+  // number of edits in a frame costs one relight and remesh per chunk touched. Light spreading past the chunk relights
+  // its neighbours in turn. Returns false if the chunk holding the block isn't loaded
+  bool SetBlockAt(int x, int y, int z, Block b);
+
+  // Finds the first solid block along a ray from origin, up to max_dist blocks away. Chunks of a single non-solid
+  // block are crossed without looking at their blocks, see VoxelRaycast
+  VoxelRaycast::Hit Raycast(const glm::vec3& origin, const glm::vec3& dir, float max_dist);
+  // As Raycast for many rays at once, resizing hits to one per ray
+  void RaycastBatch(const std::vector<VoxelRaycast::Ray>& rays, std::vector<VoxelRaycast::Hit>& hits);
+
+  // Copies a chunk and the border of its neighbours, blocks and light, ready to be meshed or lit off the main thread.
+  // With a level above 0, copies the ChunkLod node at those node coordinates instead, lit as if under open sky
+  void CreateSnapshot(int chunk_x, int chunk_y, int chunk_z, ChunkSnapshot& snapshot, int level = 0);
+
+  // Where generated chunks are saved, so they are only generated once. Safe to use from worker threads
+  inline RegionStore& GetRegionStore() { return region_store_; }
+
 private:
-  std::vector<std::unique_ptr<Chunk>> chunks_;
+  // Level 0 is full detail chunks, higher levels are ChunkLod nodes, whose coordinates are in nodes of that level
+  struct GeneratedChunk {
+    int level = 0;
+    int chunk_x = 0, chunk_y = 0, chunk_z = 0;
+    ChunkStorage blocks;
+  };
+
+  struct LitChunk {
+    int chunk_x = 0, chunk_y = 0, chunk_z = 0;
+    uint32_t instance_id = 0;
+    uint32_t version = 0;
+    ChunkLight light;
+  };
+
+  struct BuiltMesh {
+    int level = 0;
+    int chunk_x = 0, chunk_y = 0, chunk_z = 0;
+    uint32_t instance_id = 0;
+    uint32_t version = 0;
+    ChunkMesh mesh;
+    ChunkConnectivity connectivity; // Only computed for level 0
+  };
+
+  // The nodes of one ChunkLod level, held as chunks of cells so they go through the same meshing and drawing as chunks
+  struct LodLevel {
+    LodLevel(int scale) : culler(scale), mesh_pool(scale) {}
+
+    ChunkMap<std::unique_ptr<Chunk>> nodes;
+    ChunkMap<bool> pending;
+    ChunkCuller culler;
+    ChunkMeshPool mesh_pool;
+    RingQueue<glm::ivec3> remesh_queue; // Nodes whose builds are waiting for room on the workers
+  };
+
+  void ScheduleChunkGeneration(int chunk_x, int chunk_y, int chunk_z);
+  void ScheduleMeshBuild(Chunk* chunk, int level = 0);
+  void ScheduleLightBuild(Chunk* chunk);
+  void AddGeneratedChunk(GeneratedChunk& generated);
+  void AddLitChunk(LitChunk& lit);
+  void UnloadChunk(int chunk_x, int chunk_y, int chunk_z);
+  void StreamChunks(const std::shared_ptr<Camera>& camera);
+  void MeshWaitingNeighbours(int chunk_x, int chunk_y, int chunk_z);
+  void MarkMeshDirty(int chunk_x, int chunk_y, int chunk_z);
+  RingQueue<glm::ivec3>& GetRemeshQueue(int level);
+  void RemeshDirtyChunks();
+  void MarkLightDirty(int chunk_x, int chunk_y, int chunk_z);
+  void RelightDirtyChunks();
+  void SaveChunk(const Chunk& chunk);
+  void ScheduleLodBuild(int level, int node_x, int node_y, int node_z);
+  void AddLodNode(GeneratedChunk& generated);
+  void UnloadLodNodes(int level);
+  void StreamLod(bool centre_changed);
+  void DrawLevel(int level, const Frustum& frustum, const glm::vec3& eye, std::shared_ptr<cl::Shader>& shader,
+                 size_t& num_visible);
+  Chunk* GetNodeAt(int level, int chunk_x, int chunk_y, int chunk_z);
+  bool IsReadyToMesh(const Chunk* chunk);
+  bool HasVisibleFaces(const Chunk* chunk, int level);
+
+  template <typename T>
+  void PushCompleted(MpmcQueue<T>& queue, T&& value);
+
+private:
+  std::shared_ptr<cl::Context> context_;
+  ChunkMap<std::unique_ptr<Chunk>> chunks_;
+  ChunkMap<bool> pending_generation_;
+
+  ChunkCuller culler_;
+  ChunkOcclusionCuller occlusion_culler_;
+  ChunkMeshPool mesh_pool_;
+  DrawCommandBuilder draw_commands_;
+  std::vector<Chunk*> visible_chunks_;
+  RenderStats render_stats_;
+
+  ChunkStreamer streamer_;
+  std::vector<glm::ivec3> unload_queue_;
+  RingQueue<glm::ivec3> remesh_queue_;
+  RingQueue<glm::ivec3> relight_queue_;
+  size_t generations_in_flight_ = 0;
+  size_t light_builds_in_flight_ = 0;
+  size_t mesh_builds_in_flight_ = 0;
+
+  std::unique_ptr<LodLevel> lod_levels_[ChunkLod::kMaxLevels]; // Level 1 first
+  size_t lod_builds_in_flight_ = 0;
+  std::vector<std::unique_ptr<Chunk>> unloaded_nodes_; // Scratch for UnloadLodNodes, kept to reuse its memory
+  ChunkMap<bool> remeshed_nodes_;
+
+  // Declared before the job system so that they outlive the workers using them
+  RegionStore region_store_;
+  MpmcQueue<GeneratedChunk> generated_chunks_;
+  MpmcQueue<LitChunk> lit_chunks_;
+  MpmcQueue<BuiltMesh> built_meshes_;
+  MpmcQueue<ChunkMesh> spare_meshes_; // Stored meshes handed back to the workers to build into again
+  std::atomic<bool> shutting_down_ = false;
+  JobSystem job_system_;
 };